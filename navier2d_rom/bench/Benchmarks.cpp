@@ -0,0 +1,264 @@
+// Micro- and macro-benchmarks for the solver kernels.
+//
+//   ./navier2d_rom_bench                                  console table
+//   ./navier2d_rom_bench --benchmark_format=json          JSON for tracking
+//   ./navier2d_rom_bench --benchmark_filter=ReducedRHS    one family
+//
+// Every case reports time per iteration plus two rates: bytes_per_second
+// (compulsory memory traffic of the kernel) and FLOPS (counted flops of
+// the kernel), which the library prints with SI prefixes (G/s = GB/s,
+// GFLOP/s). Arguments are the grid size N (N x N grid) and, where it
+// applies, the number of modes k.
+#include <benchmark/benchmark.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include "Config.h"
+#include "GalerkinROM.h"
+#include "ModelRegistry.h"
+#include "OfflineSolver2D.h"
+#include "OnlineSolver2D.h"
+#include "POD.h"
+#include "SnapshotIO.h"
+
+namespace {
+
+Config benchConfig(int N, int k) {
+    Config cfg;
+    cfg.Nx = cfg.Ny = N;
+    cfg.Lx = cfg.Ly = 1.0;
+    cfg.dt = 0.001;
+    cfg.finalTime = 0.2;
+    cfg.viscosity = 0.01;
+    cfg.snapshotInterval = 10;
+    cfg.snapshotFile = "";
+    cfg.numPodModes = k;
+    return cfg;
+}
+
+// Flops of one explicit full-order step or residual evaluation, using the
+// same count as GalerkinROM::estimateFlopsPerStep (~18 per unknown)
+double stencilFlops(int N) {
+    return 18.0 * 2.0 * N * N;
+}
+
+// POD and ROM set-up prints progress; keep it out of the benchmark output
+struct QuietStdout {
+    QuietStdout() { std::cout.setstate(std::ios::failbit); }
+    ~QuietStdout() { std::cout.clear(); }
+};
+
+// Snapshots of a short full-order run (0.2 time units, every 10 steps),
+// generated once per grid size
+const Eigen::MatrixXd& snapshotMatrix(int N) {
+    static std::map<int, Eigen::MatrixXd> cache;
+    auto it = cache.find(N);
+    if (it != cache.end())
+        return it->second;
+    OfflineSolver2D solver(benchConfig(N, 0));
+    solver.simulate();
+    const auto& snaps = solver.snapshots();
+    Eigen::MatrixXd X(snaps.front().size(), snaps.size());
+    for (std::size_t j = 0; j < snaps.size(); j++)
+        X.col(j) = snaps[j];
+    return cache.emplace(N, std::move(X)).first->second;
+}
+
+// POD basis plus a Galerkin ROM for (N, k); the ROM keeps a reference to
+// the POD, so both live together
+struct RomFixture {
+    POD pod;
+    std::unique_ptr<GalerkinROM> rom;
+
+    RomFixture(int N, int k, bool assembled) : pod(k) {
+        QuietStdout quiet;
+        pod.computeBasis(snapshotMatrix(N));
+        double dx = 1.0 / (N - 1);
+        rom = std::make_unique<GalerkinROM>(pod, N, N, dx, dx, 0.01);
+        if (assembled)
+            rom->assembleReducedOperators();
+    }
+};
+
+} // namespace
+
+static void BM_OfflineStep(benchmark::State& state) {
+    const int N = state.range(0);
+    OfflineSolver2D solver(benchConfig(N, 0));
+    solver.initialState();
+    for (auto _ : state)
+        solver.advance(1);
+    // Read u, v and write uNext, vNext once per step
+    state.SetBytesProcessed(state.iterations() * 4.0 * N * N * sizeof(double));
+    state.counters["FLOPS"] = benchmark::Counter(state.iterations() * stencilFlops(N),
+                                                 benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_OfflineStep)->Arg(32)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_ComputeResidual(benchmark::State& state) {
+    const int N = state.range(0);
+    RomFixture fx(N, 5, false);
+    Eigen::VectorXd x = snapshotMatrix(N).col(0);
+    for (auto _ : state) {
+        Eigen::VectorXd R = fx.rom->computeResidual(x);
+        benchmark::DoNotOptimize(R.data());
+    }
+    // Read x, write R
+    state.SetBytesProcessed(state.iterations() * 2.0 * x.size() * sizeof(double));
+    state.counters["FLOPS"] = benchmark::Counter(state.iterations() * stencilFlops(N),
+                                                 benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ComputeResidual)->Arg(32)->Arg(64)->Arg(128);
+
+// Arguments: N, k, assembled (0 = reconstruct and project every call)
+static void BM_ReducedRHS(benchmark::State& state) {
+    const int N = state.range(0);
+    const int k = state.range(1);
+    const bool assembled = state.range(2) != 0;
+    RomFixture fx(N, k, assembled);
+    const int kk = fx.pod.numModes();
+    Eigen::VectorXd a = fx.pod.basis().transpose() * snapshotMatrix(N).col(0);
+    for (auto _ : state) {
+        Eigen::VectorXd rhs = fx.rom->computeReducedRHS(a);
+        benchmark::DoNotOptimize(rhs.data());
+    }
+    // Assembled: D and C; full: the basis twice (reconstruct and project)
+    double n = 2.0 * N * N;
+    double bytes = assembled ? (double(kk)*kk + double(kk)*kk*kk) * sizeof(double)
+                             : 2.0 * n * kk * sizeof(double);
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["FLOPS"] = benchmark::Counter(
+        state.iterations() * GalerkinROM::estimateFlopsPerStep(N, N, kk, assembled),
+        benchmark::Counter::kIsRate);
+    state.counters["k"] = kk;
+}
+BENCHMARK(BM_ReducedRHS)
+    ->ArgsProduct({{32, 64, 128}, {5, 10, 20}, {0, 1}})
+    ->ArgNames({"N", "k", "assembled"});
+
+// Arguments: N, k
+static void BM_PODComputeBasis(benchmark::State& state) {
+    const int N = state.range(0);
+    const int k = state.range(1);
+    const Eigen::MatrixXd& X = snapshotMatrix(N);
+    for (auto _ : state) {
+        QuietStdout quiet;
+        POD pod(k);
+        pod.computeBasis(X);
+        benchmark::DoNotOptimize(pod.basis().data());
+    }
+    // Dominant cost of the method of snapshots: the Gram matrix X^T X and
+    // the lift X V, 2nm^2 + 2nmk
+    double n = X.rows(), m = X.cols();
+    state.SetBytesProcessed(state.iterations() * n * m * sizeof(double));
+    state.counters["FLOPS"] = benchmark::Counter(state.iterations() * (2*n*m*m + 2*n*m*k),
+                                                 benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PODComputeBasis)
+    ->ArgsProduct({{32, 64, 128}, {5, 10, 20}})
+    ->ArgNames({"N", "k"})
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments: N, binary (0 = text format)
+static void BM_SnapshotWrite(benchmark::State& state) {
+    const int N = state.range(0);
+    const std::string file = state.range(1) ? "bench_snapshots.bin" : "bench_snapshots.txt";
+    const Eigen::MatrixXd& X = snapshotMatrix(N);
+    for (auto _ : state)
+        saveSnapshotMatrix(file, X);
+    state.SetBytesProcessed(state.iterations() * X.size() * sizeof(double));
+    std::remove(file.c_str());
+}
+BENCHMARK(BM_SnapshotWrite)
+    ->ArgsProduct({{64, 128}, {0, 1}})
+    ->ArgNames({"N", "binary"})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_SnapshotLoad(benchmark::State& state) {
+    const int N = state.range(0);
+    const std::string file = state.range(1) ? "bench_snapshots.bin" : "bench_snapshots.txt";
+    const Eigen::MatrixXd& X = snapshotMatrix(N);
+    saveSnapshotMatrix(file, X);
+    for (auto _ : state) {
+        Eigen::MatrixXd Y = loadSnapshotMatrix(file);
+        benchmark::DoNotOptimize(Y.data());
+    }
+    state.SetBytesProcessed(state.iterations() * X.size() * sizeof(double));
+    std::remove(file.c_str());
+}
+BENCHMARK(BM_SnapshotLoad)
+    ->ArgsProduct({{64, 128}, {0, 1}})
+    ->ArgNames({"N", "binary"})
+    ->Unit(benchmark::kMillisecond);
+
+// End to end: project the initial state, 200 assembled Euler steps,
+// reconstruct. Arguments: N, k
+static void BM_RunReducedSolve(benchmark::State& state) {
+    const int N = state.range(0);
+    const int k = state.range(1);
+    RomFixture fx(N, k, true);
+    const int kk = fx.pod.numModes();
+    Config cfg = benchConfig(N, k);
+    OnlineSolver2D online(cfg, *fx.rom);
+    Eigen::VectorXd x0 = snapshotMatrix(N).col(0);
+    for (auto _ : state) {
+        Eigen::VectorXd x = online.runReducedSolve(x0);
+        benchmark::DoNotOptimize(x.data());
+    }
+    const double steps = std::ceil(cfg.finalTime / cfg.dt);
+    const double n = 2.0 * N * N;
+    double flops = 4.0*n*kk + steps * GalerkinROM::estimateFlopsPerStep(N, N, kk, true);
+    double bytes = (2.0*n*kk + steps * (double(kk)*kk + double(kk)*kk*kk)) * sizeof(double);
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["FLOPS"] = benchmark::Counter(state.iterations() * flops,
+                                                 benchmark::Counter::kIsRate);
+    state.counters["k"] = kk;
+}
+BENCHMARK(BM_RunReducedSolve)
+    ->ArgsProduct({{32, 64, 128}, {5, 10, 20}})
+    ->ArgNames({"N", "k"});
+
+// Registry models on a batch of B initial states (64 x 64 grid, k = 10),
+// either one predictBatch call or B predict calls. items_per_second is
+// queries per second. Arguments: B, batched
+static void BM_PredictBatch(benchmark::State& state, const std::string& model) {
+    const int N = 64;
+    const int B = state.range(0);
+    const bool batched = state.range(1) != 0;
+    Config cfg = benchConfig(N, 10);
+    std::unique_ptr<ReducedOrderModel> rom = ModelRegistry::create(model, cfg);
+    {
+        QuietStdout quiet;
+        rom->train(snapshotMatrix(N));
+    }
+    const Eigen::MatrixXd& X = snapshotMatrix(N);
+    Eigen::MatrixXd X0(X.rows(), B);
+    for (int b = 0; b < B; b++)
+        X0.col(b) = X.col(b % X.cols());
+    Eigen::MatrixXd out(X0.rows(), B);
+    for (auto _ : state) {
+        if (batched) {
+            rom->predictBatch(X0, out);
+        } else {
+            for (int b = 0; b < B; b++)
+                out.col(b) = rom->predict(X0.col(b));
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * B);
+}
+BENCHMARK_CAPTURE(BM_PredictBatch, galerkin, std::string("galerkin"))
+    ->ArgsProduct({{1, 8, 32}, {0, 1}})
+    ->ArgNames({"B", "batched"});
+BENCHMARK_CAPTURE(BM_PredictBatch, opinf, std::string("opinf"))
+    ->ArgsProduct({{1, 8, 32}, {0, 1}})
+    ->ArgNames({"B", "batched"});
+BENCHMARK_CAPTURE(BM_PredictBatch, dmd, std::string("dmd"))
+    ->ArgsProduct({{1, 8, 32}, {0, 1}})
+    ->ArgNames({"B", "batched"});
+
+BENCHMARK_MAIN();
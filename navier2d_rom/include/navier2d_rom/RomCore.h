@@ -0,0 +1,66 @@
+#pragma once
+#include <Eigen/Dense>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+// In-process API of the navier2d_rom_core library: a trained reduced model
+// (any romType, as written by the train stage) queried without spawning
+// the executable or going through files per query.
+//
+// States follow the solver layout: n = 2*Nx*Ny values, u then v, with
+// grid node (i, j) at index i + j*Nx. Reduced states have numModes()
+// entries. Every query writes into caller-owned storage (Eigen::Ref, so
+// plain vectors, maps over external buffers and matrix columns all work)
+// and checks its sizes, throwing std::runtime_error on a mismatch.
+//
+//     RomCore rom("config.txt", "basis.bin");
+//     Eigen::VectorXd a(rom.numModes());
+//     rom.reduce(x0, a);
+//     rom.advance(a, 0.5);
+//     rom.reconstruct(a, x);
+//
+// A RomCore is not thread-safe; use one per thread.
+class RomCore {
+public:
+    // Loads the config (grid, dt, romType, viscosity), the basis and the
+    // model operators (operatorFile defaults to basisFile + ".ops")
+    RomCore(const std::string& configFile, const std::string& basisFile,
+            const std::string& operatorFile = "");
+    ~RomCore();
+
+    RomCore(RomCore&&) noexcept;
+    RomCore& operator=(RomCore&&) noexcept;
+
+    const std::string& modelName() const;
+    Eigen::Index stateSize() const;  // n
+    int numModes() const;            // k
+    double timeStep() const;
+
+    // Time step of step() and advance(); the config's dt initially
+    void setTimeStep(double dt);
+
+    // a = Phi^T x
+    void reduce(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::Ref<Eigen::VectorXd> a) const;
+    // Advance a in place by steps time steps (explicit Euler for
+    // Galerkin and operator inference, the exact time jump for DMD)
+    void step(Eigen::Ref<Eigen::VectorXd> a, int steps = 1);
+    // Same over time t (rounded up to whole steps, except for DMD)
+    void advance(Eigen::Ref<Eigen::VectorXd> a, double t);
+    // x = Phi a
+    void reconstruct(const Eigen::Ref<const Eigen::VectorXd>& a, Eigen::Ref<Eigen::VectorXd> x) const;
+
+    // Full states at the config's finalTime for every column of X0 (n x B)
+    void predict(const Eigen::Ref<const Eigen::MatrixXd>& X0, Eigen::Ref<Eigen::MatrixXd> out);
+
+    // Probe points (x, y) inside the domain; probe() then writes
+    // [u(p_0..), v(p_0..)] (2p values) from a in O(p k)
+    void setProbes(const std::vector<std::array<double, 2>>& points);
+    int numProbes() const;
+    void probe(const Eigen::Ref<const Eigen::VectorXd>& a, Eigen::Ref<Eigen::VectorXd> values) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
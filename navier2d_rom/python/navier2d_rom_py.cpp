@@ -0,0 +1,201 @@
+// Python bindings of the online ROM path (built when pybind11 is found):
+//
+//     import numpy as np, navier2d_rom as nr
+//     cfg = nr.Config.from_txt("config.txt")
+//     pod = nr.POD(10)
+//     pod.load_basis("basis.bin")
+//     rom = nr.GalerkinROM(pod, cfg.Nx, cfg.Ny, cfg.dx(), cfg.dy(), cfg.viscosity)
+//     rom.load_operators("basis.bin.ops")
+//     X0 = np.asfortranarray(states)            # n x B, float64
+//     out = np.empty_like(X0, order="F")
+//     nr.solve_batch(rom, X0, out, cfg.dt, 1000)
+//
+// Arrays are passed without copying when they already have the layout
+// Eigen expects: float64, and column-major (order="F") for matrices.
+// Read-only inputs in another layout are converted (one copy); writable
+// outputs (out=...) must match exactly or a TypeError is raised. Results
+// returned by value are moved into NumPy, and POD.basis is a read-only
+// view of the basis owned by the POD.
+//
+// solve_batch, run_reduced_solve, compute_basis and
+// assemble_reduced_operators release the GIL, so several Python threads
+// can solve at once. A GalerkinROM may be shared between threads once its
+// operators are assembled or loaded; an OnlineSolver2D may not (it keeps
+// its output history).
+#include <pybind11/eigen.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <Eigen/Dense>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Config.h"
+#include "Field2D.h"
+#include "GalerkinROM.h"
+#include "OnlineSolver2D.h"
+#include "POD.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+using VectorRef = Eigen::Ref<Eigen::VectorXd>;
+using ConstVectorRef = Eigen::Ref<const Eigen::VectorXd>;
+using MatrixRef = Eigen::Ref<Eigen::MatrixXd>;
+using ConstMatrixRef = Eigen::Ref<const Eigen::MatrixXd>;
+
+static void checkSize(Eigen::Index got, Eigen::Index want, const char* what) {
+    if (got != want)
+        throw std::invalid_argument(std::string(what) + " has size " + std::to_string(got)
+                                    + ", expected " + std::to_string(want));
+}
+
+PYBIND11_MODULE(navier2d_rom, m) {
+    m.doc() = "Online reduced-order model path of navier2d_rom";
+
+    py::class_<Config>(m, "Config")
+        .def(py::init<>())
+        .def_static("from_txt", &Config::fromTXT, "filename"_a)
+        .def_readwrite("Nx", &Config::Nx)
+        .def_readwrite("Ny", &Config::Ny)
+        .def_readwrite("Lx", &Config::Lx)
+        .def_readwrite("Ly", &Config::Ly)
+        .def_readwrite("dt", &Config::dt)
+        .def_readwrite("finalTime", &Config::finalTime)
+        .def_readwrite("viscosity", &Config::viscosity)
+        .def_readwrite("snapshotInterval", &Config::snapshotInterval)
+        .def_readwrite("numPodModes", &Config::numPodModes)
+        .def_readwrite("podMethod", &Config::podMethod)
+        .def_readwrite("romType", &Config::romType)
+        .def_readwrite("boundary", &Config::boundary)
+        .def("dx", &Config::dx)
+        .def("dy", &Config::dy);
+
+    py::enum_<BoundaryCondition>(m, "BoundaryCondition")
+        .value("Dirichlet", BoundaryCondition::Dirichlet)
+        .value("Periodic", BoundaryCondition::Periodic);
+
+    py::class_<POD>(m, "POD")
+        .def(py::init([](int numModes, const std::string& method) {
+                 return POD(numModes, POD::methodFromString(method));
+             }),
+             "num_modes"_a, "method"_a = "auto")
+        .def("compute_basis", [](POD& p, ConstMatrixRef X) {
+                 py::gil_scoped_release release;
+                 p.computeBasis(X);
+             }, "X"_a)
+        .def("load_basis", &POD::loadBasis, "file"_a)
+        .def("save_basis", &POD::saveBasis, "file"_a)
+        .def("set_energy_threshold", &POD::setEnergyThreshold, "fraction"_a)
+        .def_property_readonly("basis", [](const POD& p) -> ConstMatrixRef { return p.basis(); },
+                               py::return_value_policy::reference_internal)
+        .def_property_readonly("singular_values",
+                               [](const POD& p) -> ConstVectorRef { return p.singularValues(); },
+                               py::return_value_policy::reference_internal)
+        .def_property_readonly("num_modes", &POD::numModes)
+        .def_property_readonly("error_estimate", &POD::errorEstimate)
+        // a = Phi^T x and x = Phi a, into a new array or into out
+        .def("reduce", [](const POD& p, ConstVectorRef x) -> Eigen::VectorXd {
+                 checkSize(x.size(), p.basis().rows(), "x");
+                 return p.basis().transpose() * x;
+             }, "x"_a)
+        .def("reduce", [](const POD& p, ConstVectorRef x, VectorRef out) {
+                 checkSize(x.size(), p.basis().rows(), "x");
+                 checkSize(out.size(), p.basis().cols(), "out");
+                 out.noalias() = p.basis().transpose() * x;
+             }, "x"_a, "out"_a.noconvert())
+        .def("reconstruct", [](const POD& p, ConstVectorRef a) -> Eigen::VectorXd {
+                 checkSize(a.size(), p.basis().cols(), "a");
+                 return p.basis() * a;
+             }, "a"_a)
+        .def("reconstruct", [](const POD& p, ConstVectorRef a, VectorRef out) {
+                 checkSize(a.size(), p.basis().cols(), "a");
+                 checkSize(out.size(), p.basis().rows(), "out");
+                 out.noalias() = p.basis() * a;
+             }, "a"_a, "out"_a.noconvert());
+
+    // The ROM keeps a reference to its POD, which therefore stays alive
+    // as long as the ROM does
+    py::class_<GalerkinROM>(m, "GalerkinROM")
+        .def(py::init<const POD&, int, int, double, double, double, BoundaryCondition>(),
+             "pod"_a, "Nx"_a, "Ny"_a, "dx"_a, "dy"_a, "nu"_a,
+             "bc"_a = BoundaryCondition::Dirichlet, py::keep_alive<1, 2>())
+        .def("assemble_reduced_operators", &GalerkinROM::assembleReducedOperators,
+             "error_indicator"_a = false, py::call_guard<py::gil_scoped_release>())
+        .def("save_operators", &GalerkinROM::saveOperators, "file"_a)
+        .def("load_operators", &GalerkinROM::loadOperators, "file"_a)
+        .def_property_readonly("assembled", &GalerkinROM::assembled)
+        .def_property("viscosity", &GalerkinROM::viscosity, &GalerkinROM::setViscosity)
+        .def("reduced_rhs", [](GalerkinROM& r, ConstVectorRef a) -> Eigen::VectorXd {
+                 checkSize(a.size(), r.pod().numModes(), "a");
+                 return r.computeReducedRHS(a);
+             }, "a"_a)
+        .def("reduced_rhs_batch", [](GalerkinROM& r, ConstMatrixRef A) -> Eigen::MatrixXd {
+                 checkSize(A.rows(), r.pod().numModes(), "A");
+                 return r.computeReducedRHSBatch(A);
+             }, "A"_a)
+        // Explicit Euler steps of a (k) or a batch A (k x B), in place
+        .def("step", [](GalerkinROM& r, VectorRef a, double dt, int steps) {
+                 checkSize(a.size(), r.pod().numModes(), "a");
+                 py::gil_scoped_release release;
+                 Eigen::VectorXd s = a;
+                 for (int i = 0; i < steps; i++)
+                     s += dt*r.computeReducedRHS(s);
+                 a = s;
+             }, "a"_a.noconvert(), "dt"_a, "steps"_a = 1)
+        .def("step_batch", [](GalerkinROM& r, MatrixRef A, double dt, int steps) {
+                 checkSize(A.rows(), r.pod().numModes(), "A");
+                 py::gil_scoped_release release;
+                 Eigen::MatrixXd S = A;
+                 r.integrateBatch(S, dt, steps);
+                 A = S;
+             }, "A"_a.noconvert(), "dt"_a, "steps"_a = 1);
+
+    py::class_<OnlineSolver2D>(m, "OnlineSolver2D")
+        .def(py::init<const Config&, GalerkinROM&>(), "cfg"_a, "rom"_a, py::keep_alive<1, 3>())
+        .def("run_reduced_solve", [](OnlineSolver2D& s, ConstVectorRef x0) {
+                 Eigen::VectorXd x;
+                 {
+                     py::gil_scoped_release release;
+                     x = s.runReducedSolve(x0);
+                 }
+                 return x;
+             }, "x0"_a)
+        // points: p x 2 array of (x, y)
+        .def("set_probes", [](OnlineSolver2D& s, ConstMatrixRef points) {
+                 checkSize(points.cols(), 2, "points (columns)");
+                 std::vector<Eigen::Vector2d> pts;
+                 for (Eigen::Index i = 0; i < points.rows(); i++)
+                     pts.emplace_back(points(i, 0), points(i, 1));
+                 s.setProbes(pts);
+             }, "points"_a)
+        .def_property_readonly("output_times", &OnlineSolver2D::outputTimes)
+        // One row per output time: [u(p_0..), v(p_0..)]
+        .def_property_readonly("probe_history", [](const OnlineSolver2D& s) {
+                 const auto& h = s.probeHistory();
+                 Eigen::MatrixXd H(h.size(), h.empty() ? 0 : h.front().size());
+                 for (std::size_t r = 0; r < h.size(); r++)
+                     H.row(r) = h[r].transpose();
+                 return H;
+             })
+        // Rows (time, residual, relative, accumulated)
+        .def_property_readonly("error_history", [](const OnlineSolver2D& s) {
+                 const auto& h = s.errorHistory();
+                 Eigen::MatrixXd H(h.size(), 4);
+                 for (std::size_t r = 0; r < h.size(); r++)
+                     H.row(r) << h[r].time, h[r].residual, h[r].relative, h[r].accumulated;
+                 return H;
+             });
+
+    // Project, advance and reconstruct a batch (n x B) with the GIL
+    // released: out = Phi * Euler^steps(Phi^T X0)
+    m.def("solve_batch", [](GalerkinROM& rom, ConstMatrixRef X0, MatrixRef out, double dt, int steps) {
+              const Eigen::MatrixXd& Phi = rom.pod().basis();
+              checkSize(X0.rows(), Phi.rows(), "X0");
+              checkSize(out.rows(), X0.rows(), "out (rows)");
+              checkSize(out.cols(), X0.cols(), "out (columns)");
+              py::gil_scoped_release release;
+              Eigen::MatrixXd A = Phi.transpose() * X0;
+              rom.integrateBatch(A, dt, steps);
+              out.noalias() = Phi * A;
+          }, "rom"_a, "X0"_a, "out"_a.noconvert(), "dt"_a, "steps"_a);
+}
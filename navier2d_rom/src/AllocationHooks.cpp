@@ -0,0 +1,24 @@
+#include <cstdlib>
+#include <new>
+#include "Instrumentation.h"
+
+// Counting for Counter::OperatorNewCalls (Eigen's malloc-based matrix
+// storage does not pass through here). Only the plain forms are
+// replaced; the array forms forward to these, and the aligned forms keep
+// their library definitions. This file is linked into the executables
+// only, so applications embedding navier2d_rom_core keep their own global
+// operator new.
+void* operator new(std::size_t size) {
+    Instrumentation::count(Counter::OperatorNewCalls);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
@@ -3,6 +3,8 @@
 #include <sstream>
 #include <stdexcept>
 #include <iostream>
+#include "Field2D.h"
+#include "ModelRegistry.h"
 
 static std::string trim(const std::string& s) {
     const std::string whitespace = " \t\r\n";
@@ -142,5 +144,85 @@ Config Config::fromTXT(const std::string& filename)
             throw std::runtime_error("Error reading numPodModes");
     }
 
+    // Optional trailing entries, one "key value" pair per line.
+    // Unknown keys are an error so that typos do not silently keep defaults.
+    while (std::getline(ifs, line)) {
+        auto pos = line.find('#');
+        if (pos != std::string::npos)
+            line = line.substr(0, pos);
+        line = trim(line);
+        if (line.empty())
+            continue;
+        std::istringstream iss(line);
+        std::string key;
+        iss >> key;
+        bool ok = true;
+        if (key == "swirlRadius")
+            ok = static_cast<bool>(iss >> cfg.swirlRadius);
+        else if (key == "swirlAmplitude")
+            ok = static_cast<bool>(iss >> cfg.swirlAmplitude);
+        else if (key == "boundary")
+            ok = static_cast<bool>(iss >> cfg.boundary);
+        else if (key == "podMethod")
+            ok = static_cast<bool>(iss >> cfg.podMethod);
+        else if (key == "podEnergy")
+            ok = static_cast<bool>(iss >> cfg.podEnergy);
+        else if (key == "podBlockRows")
+            ok = static_cast<bool>(iss >> cfg.podBlockRows);
+        else if (key == "podOversampling")
+            ok = static_cast<bool>(iss >> cfg.podOversampling);
+        else if (key == "podPowerIterations")
+            ok = static_cast<bool>(iss >> cfg.podPowerIterations);
+        else if (key == "podSeed")
+            ok = static_cast<bool>(iss >> cfg.podSeed);
+        else if (key == "romOperators")
+            ok = static_cast<bool>(iss >> cfg.romOperators);
+        else if (key == "romType")
+            ok = static_cast<bool>(iss >> cfg.romType);
+        else if (key == "opinfRegularization")
+            ok = static_cast<bool>(iss >> cfg.opinfRegularization);
+        else if (key == "errorIndicatorFile")
+            ok = static_cast<bool>(iss >> cfg.errorIndicatorFile);
+        else if (key == "trajectoryErrorFile")
+            ok = static_cast<bool>(iss >> cfg.trajectoryErrorFile);
+        else if (key == "probeFile")
+            ok = static_cast<bool>(iss >> cfg.probeFile);
+        else if (key == "probeOutputFile")
+            ok = static_cast<bool>(iss >> cfg.probeOutputFile);
+        else if (key == "functionalsFile")
+            ok = static_cast<bool>(iss >> cfg.functionalsFile);
+        else if (key == "telemetryFile")
+            ok = static_cast<bool>(iss >> cfg.telemetryFile);
+        else if (key == "telemetryInterval")
+            ok = static_cast<bool>(iss >> cfg.telemetryInterval);
+        else if (key == "hybridThreshold")
+            ok = static_cast<bool>(iss >> cfg.hybridThreshold);
+        else if (key == "hybridFomSteps")
+            ok = static_cast<bool>(iss >> cfg.hybridFomSteps);
+        else if (key == "hybridEnrich")
+            ok = static_cast<bool>(iss >> cfg.hybridEnrich);
+        else if (key == "hybridMaxModes")
+            ok = static_cast<bool>(iss >> cfg.hybridMaxModes);
+        else if (key == "localClusters")
+            ok = static_cast<bool>(iss >> cfg.localClusters);
+        else if (key == "pararealSlices")
+            ok = static_cast<bool>(iss >> cfg.pararealSlices);
+        else if (key == "pararealMaxIterations")
+            ok = static_cast<bool>(iss >> cfg.pararealMaxIterations);
+        else if (key == "pararealTolerance")
+            ok = static_cast<bool>(iss >> cfg.pararealTolerance);
+        else if (key == "pararealCoarseFactor")
+            ok = static_cast<bool>(iss >> cfg.pararealCoarseFactor);
+        else if (key == "numThreads")
+            ok = static_cast<bool>(iss >> cfg.numThreads);
+        else
+            throw std::runtime_error("Unknown config key: " + key);
+        if (!ok)
+            throw std::runtime_error("Error reading " + key);
+    }
+    if (!ModelRegistry::has(cfg.romType))
+        throw std::runtime_error("Unknown romType: " + cfg.romType);
+    boundaryFromString(cfg.boundary);  // throws on an unknown name
+
     return cfg;
 }
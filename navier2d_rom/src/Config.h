@@ -21,6 +21,98 @@ struct Config
     // ROM
     int numPodModes;
 
+    // Optional "key value" entries after the fixed block above
+    // Initial swirl: |(x,y) - centre| < swirlRadius gets u = v = swirlAmplitude
+    double swirlRadius = 0.223606797749979; // sqrt(0.05)
+    double swirlAmplitude = 1.0;
+
+    // Boundary condition of both solvers: "dirichlet" (u = v = 0 on the
+    // boundary nodes) or "periodic" (node Nx wraps to node 0, same in y)
+    std::string boundary = "dirichlet";
+
+    // Grid spacing for the boundary condition: a Dirichlet grid has nodes
+    // on both walls, a periodic one Nx distinct nodes over one period
+    double dx() const { return Lx / (boundary == "periodic" ? Nx : Nx - 1); }
+    double dy() const { return Ly / (boundary == "periodic" ? Ny : Ny - 1); }
+
+    // POD backend: auto, jacobi, bdc, snapshots, qr, randomized or tsqr
+    // (tsqr streams the snapshot file instead of holding it in memory)
+    std::string podMethod = "auto";
+
+    // Energy-based truncation: if > 0, keep the fewest modes (at most
+    // numPodModes) capturing this fraction of the snapshot energy
+    double podEnergy = 0.0;
+
+    // Out-of-core POD (podMethod tsqr): rows per streamed block
+    int podBlockRows = 65536;
+
+    // Randomized POD: sketch size numPodModes + podOversampling
+    int podOversampling = 10;
+    int podPowerIterations = 2;
+    unsigned podSeed = 42;
+
+    // Galerkin reduced operators: "assembled" (precomputed, O(k^3) per
+    // step) or "full" (reconstruct and project every step, O(nk))
+    std::string romOperators = "assembled";
+
+    // Reduced model of the global online solve: "galerkin" (projected
+    // residual) or "opinf" (operators inferred from the snapshots by
+    // least squares with Tikhonov parameter opinfRegularization; 0 picks
+    // it by the error of the integrated model on the training data) or
+    // "dmd" (dynamic mode decomposition, evaluated in closed form at
+    // finalTime); any name added to ModelRegistry is accepted
+    std::string romType = "galerkin";
+    double opinfRegularization = 0.0;
+
+    // If set, assemble the reduced-space error indicator and write its
+    // per-step history (CSV) to this file
+    std::string errorIndicatorFile;
+
+    // If set, the run stage compares the global ROM with the offline run at
+    // every snapshot time, in reduced space, and writes the projection and
+    // reduced-dynamics errors (CSV) to this file
+    std::string trajectoryErrorFile;
+
+    // Output probes: "x y" points read from probeFile; u, v at those points
+    // are written for every online step to probeOutputFile (CSV)
+    std::string probeFile;
+    std::string probeOutputFile = "probes.csv";
+
+    // If set, write the reduced output functionals (energy, enstrophy, mean
+    // vorticity, midline flux) for every online step to this file (CSV)
+    std::string functionalsFile;
+
+    // If set, stream per-step telemetry (time, max |u|, CFL, energy, step
+    // wall time) of the offline and online solves to this file while they
+    // run (".bin" = binary, otherwise CSV), every telemetryInterval steps
+    std::string telemetryFile;
+    int telemetryInterval = 1;
+
+    // Hybrid ROM/full-order solve: fall back to OfflineSolver2D for
+    // hybridFomSteps steps whenever the relative error indicator exceeds
+    // hybridThreshold (0 = pure ROM), enriching the basis with the new
+    // states if hybridEnrich, up to hybridMaxModes modes
+    double hybridThreshold = 0.0;
+    int hybridFomSteps = 10;
+    int hybridEnrich = 1;
+    int hybridMaxModes = 30;
+
+    // Localized ROM: number of k-means clusters of the snapshots, each with
+    // its own basis (0 = single global basis)
+    int localClusters = 0;
+
+    // Parareal stage: time slices (0 = numThreads()), iteration cap (0 =
+    // slices, which always reproduces the serial solve), convergence
+    // tolerance on the relative update of the slice boundaries, and the
+    // coarse-to-fine time step ratio of the coarse propagator
+    int pararealSlices = 0;
+    int pararealMaxIterations = 0;
+    double pararealTolerance = 1e-6;
+    int pararealCoarseFactor = 10;
+
+    // Worker threads for parallel stages (0 = hardware concurrency)
+    int numThreads = 0;
+
     // Read from a plain text file
     static Config fromTXT(const std::string& filename);
 };
@@ -0,0 +1,175 @@
+#include "DMDROM.h"
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <Eigen/Eigenvalues>
+#include "Instrumentation.h"
+
+static const char kMagic[8] = {'N', '2', 'D', 'D', 'M', 'D', '0', '1'};
+
+DMDROM::DMDROM(const Config& cfg)
+    : cfg_(cfg),
+      pod_(cfg.numPodModes,
+           POD::methodFromString(cfg.podMethod == "tsqr" ? "auto" : cfg.podMethod))
+{
+    pod_.setRandomizedOptions(cfg.podOversampling, cfg.podPowerIterations, cfg.podSeed);
+    pod_.setEnergyThreshold(cfg.podEnergy);
+}
+
+void DMDROM::train(const Eigen::MatrixXd& X) {
+    pod_.computeBasis(X);
+    train(pod_, X);
+}
+
+void DMDROM::train(const POD& pod, const Eigen::MatrixXd& X) {
+    // OfflineSolver2D stores steps 0, I, 2I, ... <= ceil(T/dt), then the
+    // final state once more
+    const int steps = static_cast<int>(std::ceil(cfg_.finalTime/cfg_.dt));
+    const int regular = steps/cfg_.snapshotInterval + 1;
+    if (X.cols() != regular + 1)
+        throw std::runtime_error("DMDROM: snapshot count does not match the config's "
+                                 "schedule; use fit() with the sampling interval");
+    fit(pod, X.leftCols(regular), cfg_.snapshotInterval*cfg_.dt);
+}
+
+void DMDROM::fit(const POD& pod, const Eigen::MatrixXd& X, double sampleDt) {
+    ScopedTimer timer("dmdFit");
+    if (X.cols() < 2)
+        throw std::runtime_error("DMDROM: need at least 2 snapshots");
+    if (&pod != &pod_)
+        pod_ = pod;
+    sampleDt_ = sampleDt;
+    const int m = X.cols();
+
+    // Reduced linear map by least squares, Atilde = Y2 Y1^+
+    Eigen::MatrixXd Y = pod_.basis().transpose() * X;
+    Eigen::MatrixXd Y1 = Y.leftCols(m - 1), Y2 = Y.rightCols(m - 1);
+    Eigen::MatrixXd At = Y1.transpose().completeOrthogonalDecomposition()
+                           .solve(Y2.transpose()).transpose();
+
+    Eigen::EigenSolver<Eigen::MatrixXd> eig(At);
+    if (eig.info() != Eigen::Success)
+        throw std::runtime_error("DMDROM: eigendecomposition failed");
+    lambda_ = eig.eigenvalues();
+    W_ = eig.eigenvectors();
+    factorize();
+
+    double maxAbs = lambda_.cwiseAbs().maxCoeff();
+    std::cout << "[DMDROM] Fitted " << lambda_.size() << " modes on " << m
+              << " snapshots (h = " << sampleDt << "), max |lambda| " << maxAbs << "\n";
+    if (maxAbs > 1.0 + 1e-8)
+        std::cerr << "[DMDROM] Warning: growing modes; long-time predictions will diverge\n";
+}
+
+void DMDROM::factorize() {
+    Wlu_.compute(W_);
+    omega_ = lambda_.unaryExpr([&](std::complex<double> l) { return std::log(l) / sampleDt_; });
+}
+
+Eigen::MatrixXcd DMDROM::modes() const {
+    return pod_.basis().cast<std::complex<double>>() * W_;
+}
+
+Eigen::VectorXcd DMDROM::growth(double t) const {
+    if (lambda_.size() == 0)
+        throw std::runtime_error("DMDROM: model not trained");
+    Eigen::VectorXcd g(lambda_.size());
+    for (Eigen::Index i = 0; i < g.size(); i++)
+        g(i) = (lambda_(i) == 0.0) ? (t == 0.0 ? 1.0 : 0.0) : std::exp(omega_(i)*t);
+    return g;
+}
+
+Eigen::VectorXcd DMDROM::amplitudes(const Eigen::VectorXd& initialState) const {
+    Eigen::VectorXcd a0 = (pod_.basis().transpose() * initialState).cast<std::complex<double>>();
+    return Wlu_.solve(a0);
+}
+
+Eigen::VectorXd DMDROM::advanceReduced(const Eigen::VectorXd& a, double t) const {
+    Eigen::VectorXcd b = Wlu_.solve(a.cast<std::complex<double>>().eval());
+    return (W_ * growth(t).cwiseProduct(b)).real();
+}
+
+Eigen::VectorXd DMDROM::predictAt(const Eigen::VectorXcd& b, double t) const {
+    // Re(Phi W s) = Phi Re(W s): the O(nk) product stays real
+    Eigen::VectorXcd scaled = growth(t).cwiseProduct(b);
+    return pod_.basis() * (W_ * scaled).real();
+}
+
+Eigen::VectorXd DMDROM::predictAt(const Eigen::VectorXd& initialState, double t) const {
+    return predictAt(amplitudes(initialState), t);
+}
+
+Eigen::VectorXd DMDROM::predict(const Eigen::VectorXd& initialState) {
+    ScopedTimer timer("online");
+    return predictAt(initialState, cfg_.finalTime);
+}
+
+void DMDROM::predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X0,
+                          Eigen::Ref<Eigen::MatrixXd> out) {
+    ScopedTimer timer("online");
+    if (out.rows() != X0.rows() || out.cols() != X0.cols())
+        throw std::runtime_error("predictBatch: output must match the input size");
+    if (X0.rows() != pod_.basis().rows())
+        throw std::runtime_error("predictBatch: input does not match the basis size");
+    Eigen::MatrixXcd A0 = (pod_.basis().transpose() * X0).cast<std::complex<double>>();
+    Eigen::MatrixXcd B = growth(cfg_.finalTime).asDiagonal() * Wlu_.solve(A0);
+    Eigen::MatrixXd A = (W_ * B).real();
+    out.noalias() = pod_.basis() * A;
+}
+
+void DMDROM::saveResults(const std::string& filename) {
+    saveSpectrum(filename);
+}
+
+void DMDROM::saveSpectrum(const std::string& file) const {
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs.precision(12);
+    ofs << "mode,lambdaRe,lambdaIm,growthRate,frequency\n";
+    for (Eigen::Index i = 0; i < lambda_.size(); i++)
+        ofs << i << "," << lambda_(i).real() << "," << lambda_(i).imag() << ","
+            << omega_(i).real() << "," << omega_(i).imag() << "\n";
+}
+
+void DMDROM::save(const std::string& basisFile, const std::string& operatorFile) const {
+    pod_.saveBasis(basisFile);
+    std::ofstream ofs(operatorFile, std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + operatorFile);
+    std::int64_t k = lambda_.size();
+    ofs.write(kMagic, 8);
+    ofs.write(reinterpret_cast<const char*>(&k), sizeof(k));
+    ofs.write(reinterpret_cast<const char*>(&sampleDt_), sizeof(sampleDt_));
+    ofs.write(reinterpret_cast<const char*>(lambda_.data()), lambda_.size()*sizeof(lambda_(0)));
+    ofs.write(reinterpret_cast<const char*>(W_.data()), W_.size()*sizeof(W_(0)));
+    if (!ofs)
+        throw std::runtime_error("Error writing " + operatorFile);
+    Instrumentation::count(Counter::BytesWritten, static_cast<std::int64_t>(ofs.tellp()));
+}
+
+void DMDROM::load(const std::string& basisFile, const std::string& operatorFile) {
+    pod_.loadBasis(basisFile);
+    std::ifstream ifs(operatorFile, std::ios::binary);
+    if (!ifs.is_open())
+        throw std::runtime_error("Cannot open " + operatorFile);
+    char magic[8] = {};
+    std::int64_t k = 0;
+    ifs.read(magic, 8);
+    if (!ifs || std::string(magic, 8) != std::string(kMagic, 8))
+        throw std::runtime_error(operatorFile + " is not a DMD model");
+    ifs.read(reinterpret_cast<char*>(&k), sizeof(k));
+    if (!ifs || k != pod_.basis().cols())
+        throw std::runtime_error("Operator file " + operatorFile + " does not match the basis");
+    ifs.read(reinterpret_cast<char*>(&sampleDt_), sizeof(sampleDt_));
+    lambda_.resize(k);
+    W_.resize(k, k);
+    ifs.read(reinterpret_cast<char*>(lambda_.data()), lambda_.size()*sizeof(lambda_(0)));
+    ifs.read(reinterpret_cast<char*>(W_.data()), W_.size()*sizeof(W_(0)));
+    if (!ifs)
+        throw std::runtime_error("Truncated operator file " + operatorFile);
+    Instrumentation::count(Counter::BytesRead, static_cast<std::int64_t>(ifs.tellg()));
+    factorize();
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <Eigen/Dense>
+#include <string>
+#include "Config.h"
+#include "POD.h"
+#include "ReducedOrderModel.h"
+
+// Projected exact DMD on a POD basis: with Y = Phi^T X sampled every h,
+// fit the linear map Y_{j+1} = Atilde Y_j by least squares, and
+// diagonalize Atilde = W diag(lambda) W^{-1}. Then
+//
+//     x(t) ~ Re( Psi diag(exp(omega t)) b ),  Psi = Phi W,  omega = log(lambda) / h,
+//
+// with amplitudes b = W^{-1} Phi^T x0. A prediction at any t costs k
+// complex exponentials and one n x k reconstruction, independent of the
+// number of time steps. Best suited to (nearly) linear, decaying
+// dynamics; nonlinear transients are fitted only in a least-squares sense.
+class DMDROM : public ReducedOrderModel {
+public:
+    // Uses numPodModes, podMethod, podEnergy, dt, finalTime and
+    // snapshotInterval from cfg
+    explicit DMDROM(const Config& cfg);
+
+    // POD of X, then the DMD fit. Only the columns OfflineSolver2D writes
+    // every snapshotInterval steps are used (the extra final snapshot is off
+    // the uniform grid or a duplicate).
+    void train(const Eigen::MatrixXd& X) override;
+    // Same with a basis already computed from X
+    void train(const POD& pod, const Eigen::MatrixXd& X) override;
+    // Fit on columns sampled uniformly every sampleDt
+    void fit(const POD& pod, const Eigen::MatrixXd& X, double sampleDt);
+
+    // State at cfg.finalTime
+    Eigen::VectorXd predict(const Eigen::VectorXd& initialState) override;
+    // State at any time t >= 0
+    Eigen::VectorXd predictAt(const Eigen::VectorXd& initialState, double t) const;
+    // Same from precomputed amplitudes (skips the O(nk) projection)
+    Eigen::VectorXd predictAt(const Eigen::VectorXcd& amplitudes, double t) const;
+    Eigen::VectorXcd amplitudes(const Eigen::VectorXd& initialState) const;
+    // Reduced coordinates a(t0 + t) from a(t0), O(k^2)
+    Eigen::VectorXd advanceReduced(const Eigen::VectorXd& a, double t) const;
+    // Whole batch at cfg.finalTime with one projection and one
+    // reconstruction GEMM
+    void predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X0,
+                      Eigen::Ref<Eigen::MatrixXd> out) override;
+
+    // Writes the spectrum (see saveSpectrum)
+    void saveResults(const std::string& filename) override;
+    // CSV: mode, Re/Im of lambda, growth rate Re(omega), frequency Im(omega)
+    void saveSpectrum(const std::string& file) const;
+
+    // Model I/O: the basis, and the operator file (binary: magic "N2DDMD01",
+    // int64 k, sampling interval, then lambda and W as complex doubles,
+    // column-major)
+    void save(const std::string& basisFile, const std::string& operatorFile) const override;
+    void load(const std::string& basisFile, const std::string& operatorFile) override;
+
+    const POD& pod() const { return pod_; }
+    const Eigen::VectorXcd& eigenvalues() const { return lambda_; }  // discrete
+    const Eigen::VectorXcd& rates() const { return omega_; }         // continuous
+    // Full-space DMD modes Phi W (n x k), formed on each call; the model
+    // itself only needs W
+    Eigen::MatrixXcd modes() const;
+
+private:
+    Config cfg_;
+    POD pod_;
+    double sampleDt_ = 0.0;
+    Eigen::VectorXcd lambda_, omega_;
+    Eigen::MatrixXcd W_;
+    Eigen::PartialPivLU<Eigen::MatrixXcd> Wlu_;
+
+    // Rates and LU of W from lambda_ and W_
+    void factorize();
+    // exp(omega_i t) (lambda_i^(t/h)); a zero eigenvalue only survives t = 0
+    Eigen::VectorXcd growth(double t) const;
+};
@@ -0,0 +1,113 @@
+#include "Field2D.h"
+#include <algorithm>
+#include <stdexcept>
+
+BoundaryCondition boundaryFromString(const std::string& name) {
+    if (name == "dirichlet") return BoundaryCondition::Dirichlet;
+    if (name == "periodic")  return BoundaryCondition::Periodic;
+    throw std::runtime_error("Unknown boundary condition: " + name);
+}
+
+// Doubles per 64-byte line; node 0 of a row sits one line into it, so the
+// left ghost is the last entry of that first line
+static constexpr std::ptrdiff_t kLine = 8;
+
+Field2D::Field2D(int nx, int ny)
+    : nx_(nx), ny_(ny)
+{
+    if (nx < 1 || ny < 1)
+        throw std::runtime_error("Field2D: empty grid");
+    stride_ = (kLine + nx + 1 + kLine - 1) / kLine * kLine;
+    origin_ = stride_ + kLine;
+    data_.assign(stride_*(ny + 2), 0.0);
+}
+
+void Field2D::load(const double* src) {
+    for (int j = 0; j < ny_; j++)
+        std::copy(src + j*nx_, src + (j+1)*nx_, row(j));
+}
+
+void Field2D::store(double* dst) const {
+    for (int j = 0; j < ny_; j++)
+        std::copy(row(j), row(j) + nx_, dst + j*nx_);
+}
+
+void Field2D::fillGhosts(BoundaryCondition bc, double value) {
+    if (bc == BoundaryCondition::Dirichlet) {
+        std::fill(row(-1) - 1, row(-1) + nx_ + 1, value);
+        std::fill(row(ny_) - 1, row(ny_) + nx_ + 1, value);
+        for (int j = 0; j < ny_; j++) {
+            row(j)[-1] = value;
+            row(j)[nx_] = value;
+        }
+    } else {
+        for (int j = 0; j < ny_; j++) {
+            row(j)[-1] = row(j)[nx_ - 1];
+            row(j)[nx_] = row(j)[0];
+        }
+        // Whole rows including their x ghosts, which fills the corners
+        std::copy(row(ny_ - 1) - 1, row(ny_ - 1) + nx_ + 1, row(-1) - 1);
+        std::copy(row(0) - 1, row(0) + nx_ + 1, row(ny_) - 1);
+    }
+}
+
+void Field2D::applyBoundary(BoundaryCondition bc, double value) {
+    if (bc != BoundaryCondition::Dirichlet)
+        return;
+    std::fill(row(0), row(0) + nx_, value);
+    std::fill(row(ny_ - 1), row(ny_ - 1) + nx_, value);
+    for (int j = 1; j < ny_ - 1; j++) {
+        row(j)[0] = value;
+        row(j)[nx_ - 1] = value;
+    }
+}
+
+void laplacianRow(const Field2D& phi, int j, double dx, double dy, double* out) {
+    const double* c = phi.row(j);
+    const double* s = phi.row(j - 1);
+    const double* n = phi.row(j + 1);
+    const int nx = phi.nx();
+    for (int i = 0; i < nx; i++) {
+        double d2x = (c[i-1] - 2*c[i] + c[i+1])/(dx*dx);
+        double d2y = (s[i] - 2*c[i] + n[i])/(dy*dy);
+        out[i] = d2x + d2y;
+    }
+}
+
+void convectionRow(const Field2D& wu, const Field2D& wv, const Field2D& u, int j,
+                   double dx, double dy, double* out) {
+    const double* a = wu.row(j);
+    const double* b = wv.row(j);
+    const double* c = u.row(j);
+    const double* s = u.row(j - 1);
+    const double* n = u.row(j + 1);
+    const int nx = u.nx();
+    for (int i = 0; i < nx; i++) {
+        double dudx = (c[i+1] - c[i-1])/(2*dx);
+        double dudy = (n[i] - s[i])/(2*dy);
+        out[i] = a[i]*dudx + b[i]*dudy;
+    }
+}
+
+void residualRow(const Field2D& u, const Field2D& v, int j, double nu, double dx, double dy,
+                 double* Ru, double* Rv) {
+    const double* uc = u.row(j);
+    const double* us = u.row(j - 1);
+    const double* un = u.row(j + 1);
+    const double* vc = v.row(j);
+    const double* vs = v.row(j - 1);
+    const double* vn = v.row(j + 1);
+    const int nx = u.nx();
+    for (int i = 0; i < nx; i++) {
+        double dudx = (uc[i+1] - uc[i-1])/(2*dx);
+        double dudy = (un[i] - us[i])/(2*dy);
+        double dvdx = (vc[i+1] - vc[i-1])/(2*dx);
+        double dvdy = (vn[i] - vs[i])/(2*dy);
+        double convU = uc[i]*dudx + vc[i]*dudy;
+        double convV = uc[i]*dvdx + vc[i]*dvdy;
+        double lapU = (uc[i-1] - 2*uc[i] + uc[i+1])/(dx*dx) + (us[i] - 2*uc[i] + un[i])/(dy*dy);
+        double lapV = (vc[i-1] - 2*vc[i] + vc[i+1])/(dx*dx) + (vs[i] - 2*vc[i] + vn[i])/(dy*dy);
+        Ru[i] = -convU + nu*lapU;
+        Rv[i] = -convV + nu*lapV;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+enum class BoundaryCondition {
+    Dirichlet,  // boundary nodes (and ghosts) held at a fixed value
+    Periodic    // node i + nx is node i (likewise in y); no boundary nodes
+};
+
+BoundaryCondition boundaryFromString(const std::string& name);  // "dirichlet", "periodic"
+
+// Allocator for 64-byte (cache line, AVX-512) aligned storage
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+    static constexpr std::size_t kAlign = 64;
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        std::size_t bytes = (n*sizeof(T) + kAlign - 1) / kAlign * kAlign;
+        if (void* p = std::aligned_alloc(kAlign, bytes))
+            return static_cast<T*>(p);
+        throw std::bad_alloc();
+    }
+    void deallocate(T* p, std::size_t) { std::free(p); }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+// Scalar field on an nx x ny node grid with a one-node ghost layer on
+// every side. Node (i, j), -1 <= i <= nx, -1 <= j <= ny, is stored at
+// i + j*stride() from the first node; every row starts on a 64-byte
+// boundary (the left ghost sits just before it) and the stride is padded
+// to a whole number of cache lines. Once the ghosts are filled, a
+// five-point stencil can sweep whole rows i = 0..nx-1 with no boundary
+// branches.
+//
+// The solver state layout (node (i, j) at i + j*nx, no ghosts) is
+// converted with load/store.
+class Field2D {
+public:
+    Field2D() = default;
+    Field2D(int nx, int ny);  // all nodes and ghosts zero
+
+    int nx() const { return nx_; }
+    int ny() const { return ny_; }
+    std::ptrdiff_t stride() const { return stride_; }
+
+    double& operator()(int i, int j) { return data_[origin_ + i + j*stride_]; }
+    double operator()(int i, int j) const { return data_[origin_ + i + j*stride_]; }
+
+    // Pointer to node (0, j); row(j)[-1] and row(j)[nx] are ghosts
+    double* row(int j) { return data_.data() + origin_ + j*stride_; }
+    const double* row(int j) const { return data_.data() + origin_ + j*stride_; }
+
+    // Nodes from / to the solver layout (nx*ny values); ghosts untouched
+    void load(const double* src);
+    void store(double* dst) const;
+
+    // Fill the ghost layer: Dirichlet sets it to value, Periodic copies the
+    // opposite edge (corners included)
+    void fillGhosts(BoundaryCondition bc, double value = 0.0);
+
+    // Dirichlet: set the boundary nodes (i = 0, nx-1 or j = 0, ny-1) to
+    // value. Periodic: nothing to do.
+    void applyBoundary(BoundaryCondition bc, double value = 0.0);
+
+    void swap(Field2D& other) { data_.swap(other.data_); }
+
+private:
+    int nx_ = 0, ny_ = 0;
+    std::ptrdiff_t stride_ = 0;
+    std::ptrdiff_t origin_ = 0;  // index of node (0, 0)
+    std::vector<double, CacheAlignedAllocator<double>> data_;
+};
+
+// Discrete operators of the Burgers residual on Field2D, central
+// differences. Each sweeps all nodes of one row (the ghosts must be
+// filled), so both solvers share the same arithmetic:
+//
+//   laplacianRow:  out = d2/dx2 phi + d2/dy2 phi
+//   convectionRow: out = wu du/dx + wv du/dy
+//   residualRow:   Ru = -(u du/dx + v du/dy) + nu lap u, same for Rv
+void laplacianRow(const Field2D& phi, int j, double dx, double dy, double* out);
+void convectionRow(const Field2D& wu, const Field2D& wv, const Field2D& u, int j,
+                   double dx, double dy, double* out);
+void residualRow(const Field2D& u, const Field2D& v, int j, double nu, double dx, double dy,
+                 double* Ru, double* Rv);
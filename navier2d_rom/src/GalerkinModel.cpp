@@ -0,0 +1,73 @@
+#include "GalerkinModel.h"
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include "Instrumentation.h"
+#include "OnlineSolver2D.h"
+
+GalerkinModel::GalerkinModel(const Config& cfg)
+    : cfg_(cfg),
+      pod_(cfg.numPodModes,
+           POD::methodFromString(cfg.podMethod == "tsqr" ? "auto" : cfg.podMethod))
+{
+    pod_.setRandomizedOptions(cfg.podOversampling, cfg.podPowerIterations, cfg.podSeed);
+    pod_.setEnergyThreshold(cfg.podEnergy);
+}
+
+void GalerkinModel::makeRom() {
+    double dx = cfg_.dx();
+    double dy = cfg_.dy();
+    rom_ = std::make_unique<GalerkinROM>(pod_, cfg_.Nx, cfg_.Ny, dx, dy, cfg_.viscosity,
+                                         boundaryFromString(cfg_.boundary));
+}
+
+void GalerkinModel::train(const Eigen::MatrixXd& X) {
+    pod_.computeBasis(X);
+    makeRom();
+    rom_->assembleReducedOperators(!cfg_.errorIndicatorFile.empty());
+}
+
+void GalerkinModel::train(const POD& pod, const Eigen::MatrixXd&) {
+    pod_ = pod;
+    makeRom();
+    rom_->assembleReducedOperators(!cfg_.errorIndicatorFile.empty());
+}
+
+GalerkinROM& GalerkinModel::rom() {
+    if (!rom_)
+        throw std::runtime_error("GalerkinModel: model not trained");
+    return *rom_;
+}
+
+Eigen::VectorXd GalerkinModel::predict(const Eigen::VectorXd& initialState) {
+    OnlineSolver2D online(cfg_, rom());
+    return online.runReducedSolve(initialState);
+}
+
+void GalerkinModel::predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X0,
+                                 Eigen::Ref<Eigen::MatrixXd> out) {
+    ScopedTimer timer("online");
+    if (out.rows() != X0.rows() || out.cols() != X0.cols())
+        throw std::runtime_error("predictBatch: output must match the input size");
+    if (X0.rows() != pod_.basis().rows())
+        throw std::runtime_error("predictBatch: input does not match the basis size");
+    const Eigen::MatrixXd& Phi = pod_.basis();
+    Eigen::MatrixXd A = Phi.transpose() * X0;
+    const int steps = static_cast<int>(std::ceil(cfg_.finalTime/cfg_.dt));
+    rom().integrateBatch(A, cfg_.dt, steps);
+    Instrumentation::count(Counter::Steps, static_cast<std::int64_t>(steps)*X0.cols());
+    out.noalias() = Phi * A;
+}
+
+void GalerkinModel::save(const std::string& basisFile, const std::string& operatorFile) const {
+    if (!rom_)
+        throw std::runtime_error("GalerkinModel: model not trained");
+    pod_.saveBasis(basisFile);
+    rom_->saveOperators(operatorFile);
+}
+
+void GalerkinModel::load(const std::string& basisFile, const std::string& operatorFile) {
+    pod_.loadBasis(basisFile);
+    makeRom();
+    rom_->loadOperators(operatorFile);
+}
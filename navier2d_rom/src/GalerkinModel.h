@@ -0,0 +1,47 @@
+#pragma once
+#include <Eigen/Dense>
+#include <memory>
+#include <string>
+#include "Config.h"
+#include "GalerkinROM.h"
+#include "POD.h"
+#include "ReducedOrderModel.h"
+
+// The POD-Galerkin ROM as a self-contained ReducedOrderModel: owns its
+// basis and the assembled operators, so it can be created, trained,
+// saved and loaded through the model registry like the data-driven
+// models. The GalerkinROM refers to the owned POD, so the model is not
+// copyable.
+class GalerkinModel : public ReducedOrderModel {
+public:
+    // Uses the grid, viscosity, POD options and errorIndicatorFile (to
+    // assemble the indicator Gram matrices) from cfg
+    explicit GalerkinModel(const Config& cfg);
+
+    GalerkinModel(const GalerkinModel&) = delete;
+    GalerkinModel& operator=(const GalerkinModel&) = delete;
+
+    // POD of X, then operator assembly
+    void train(const Eigen::MatrixXd& X) override;
+    void train(const POD& pod, const Eigen::MatrixXd& X) override;
+
+    // Integrates to cfg.finalTime with OnlineSolver2D
+    Eigen::VectorXd predict(const Eigen::VectorXd& initialState) override;
+    // Whole batch as one k x B block with batched operator products
+    void predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X0,
+                      Eigen::Ref<Eigen::MatrixXd> out) override;
+
+    // Basis and GalerkinROM operator files, as written by the train stage
+    void save(const std::string& basisFile, const std::string& operatorFile) const override;
+    void load(const std::string& basisFile, const std::string& operatorFile) override;
+
+    GalerkinROM& rom();
+    const POD& pod() const { return pod_; }
+
+private:
+    Config cfg_;
+    POD pod_;
+    std::unique_ptr<GalerkinROM> rom_;
+
+    void makeRom();
+};
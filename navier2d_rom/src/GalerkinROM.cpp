@@ -1,9 +1,18 @@
 #include "GalerkinROM.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
-
-GalerkinROM::GalerkinROM(const POD& pod, int Nx, int Ny, double dx, double dy, double nu)
-    : pod_(pod), Nx_(Nx), Ny_(Ny), dx_(dx), dy_(dy), nu_(nu)
+#include <stdexcept>
+#include "Field2D.h"
+#include "Instrumentation.h"
+#include "Parallel.h"
+#include "ParallelLinAlg.h"
+
+GalerkinROM::GalerkinROM(const POD& pod, int Nx, int Ny, double dx, double dy, double nu,
+                         BoundaryCondition bc)
+    : pod_(pod), Nx_(Nx), Ny_(Ny), dx_(dx), dy_(dy), nu_(nu), bc_(bc)
 {
     n_ = 2*Nx_*Ny_; // we store [u, v]
 }
@@ -13,77 +22,229 @@ Eigen::VectorXd GalerkinROM::reconstructFull(const Eigen::VectorXd& a) {
     return pod_.basis() * a;
 }
 
+// u and v halves of a flattened [u, v] vector, ghosts filled
+static void loadVelocity(const Eigen::VectorXd& x, BoundaryCondition bc, Field2D& u, Field2D& v) {
+    u.load(x.data());
+    v.load(x.data() + u.nx()*u.ny());
+    u.fillGhosts(bc);
+    v.fillGhosts(bc);
+}
+
+// Dirichlet: zero the boundary nodes of both components of x
+static void zeroBoundary(Eigen::VectorXd& x, int Nx, int Ny) {
+    for (int c = 0; c < 2; c++) {
+        double* p = x.data() + c*Nx*Ny;
+        std::fill(p, p + Nx, 0.0);
+        std::fill(p + (Ny-1)*Nx, p + Ny*Nx, 0.0);
+        for (int j = 1; j < Ny-1; j++) {
+            p[j*Nx] = 0.0;
+            p[j*Nx + Nx-1] = 0.0;
+        }
+    }
+}
+
 // PDE residual in full dimension
 // R(u) = - (u dot grad)u + nu lap(u)
 Eigen::VectorXd GalerkinROM::computeResidual(const Eigen::VectorXd& uFull) {
     // uFull(0..Nx_*Ny_-1) => U
     // uFull(Nx_*Ny_..2*Nx_*Ny_-1) => V
     // We'll produce R(0..Nx_*Ny_-1) for dU/dt, R(Nx_*Ny_..end) for dV/dt
+    Field2D u(Nx_, Ny_), v(Nx_, Ny_);
+    loadVelocity(uFull, bc_, u, v);
+
+    Eigen::VectorXd R(n_);
+    for(int j=0; j<Ny_; j++)
+        residualRow(u, v, j, nu_, dx_, dy_, R.data() + j*Nx_, R.data() + j*Nx_ + Nx_*Ny_);
+    if (bc_ == BoundaryCondition::Dirichlet)
+        zeroBoundary(R, Nx_, Ny_);
+    return R;
+}
 
-    Eigen::VectorXd R = Eigen::VectorXd::Zero(n_);
-
-    auto idx = [&](int i, int j){ return i + j*Nx_; };
-
-    // Convert to 2D arrays for easier stencils
-    // but let's do it in-situ
-    // Let U(i,j) = uFull( idx(i,j) ),  V(i,j)=uFull( idx(i,j)+Nx_*Ny_ )
-
-    // Central differences for gradients
-    for(int j=1; j<Ny_-1; j++){
-        for(int i=1; i<Nx_-1; i++){
-            int base = idx(i,j);
-            double uij = uFull(base);
-            double vij = uFull(base + Nx_*Ny_);
-
-            // partial derivatives
-            auto dudx = (uFull(base+1)     - uFull(base-1))     / (2*dx_);
-            auto dudy = (uFull(base+Nx_)   - uFull(base-Nx_))   / (2*dy_);
-            auto dvdx = (uFull(base+1+Nx_*Ny_) - uFull(base-1+Nx_*Ny_)) / (2*dx_);
-            auto dvdy = (uFull(base+Nx_+Nx_*Ny_) - uFull(base-Nx_+Nx_*Ny_)) / (2*dy_);
-
-            // convection
-            double convU = uij*dudx + vij*dudy;
-            double convV = uij*dvdx + vij*dvdy;
-
-            // Laplacian
-            auto lap = [&](auto indexOffset){
-                double left  = uFull(base-1+indexOffset);
-                double right = uFull(base+1+indexOffset);
-                double up    = uFull(base+Nx_+indexOffset);
-                double down  = uFull(base-Nx_+indexOffset);
-                double cent  = uFull(base+indexOffset);
-                double d2x = (left - 2*cent + right)/(dx_*dx_);
-                double d2y = (down - 2*cent + up)/(dy_*dy_);
-                return d2x + d2y;
-            };
-
-            double lapU = lap(0);
-            double lapV = lap(Nx_*Ny_);
-
-            R(base)              = -convU + nu_*lapU;
-            R(base+Nx_*Ny_)      = -convV + nu_*lapV;
-        }
+Eigen::VectorXd GalerkinROM::convection(const Eigen::VectorXd& w,
+                                        const Eigen::VectorXd& u) const {
+    Field2D wu(Nx_, Ny_), wv(Nx_, Ny_), uu(Nx_, Ny_), uv(Nx_, Ny_);
+    loadVelocity(w, bc_, wu, wv);
+    loadVelocity(u, bc_, uu, uv);
+
+    Eigen::VectorXd N(n_);
+    const int off = Nx_*Ny_;
+    for(int j=0; j<Ny_; j++){
+        convectionRow(wu, wv, uu, j, dx_, dy_, N.data() + j*Nx_);
+        convectionRow(wu, wv, uv, j, dx_, dy_, N.data() + j*Nx_ + off);
     }
+    if (bc_ == BoundaryCondition::Dirichlet)
+        zeroBoundary(N, Nx_, Ny_);
+    return N;
+}
 
-    // zero boundary
-    // for simplicity
-    // you could do better BC approximations
-    return R;
+Eigen::VectorXd GalerkinROM::laplacian(const Eigen::VectorXd& u) const {
+    Field2D uu(Nx_, Ny_), uv(Nx_, Ny_);
+    loadVelocity(u, bc_, uu, uv);
+
+    Eigen::VectorXd L(n_);
+    const int off = Nx_*Ny_;
+    for(int j=0; j<Ny_; j++){
+        laplacianRow(uu, j, dx_, dy_, L.data() + j*Nx_);
+        laplacianRow(uv, j, dx_, dy_, L.data() + j*Nx_ + off);
+    }
+    if (bc_ == BoundaryCondition::Dirichlet)
+        zeroBoundary(L, Nx_, Ny_);
+    return L;
+}
+
+// a kron a, index j*k + l
+static Eigen::VectorXd selfKron(const Eigen::VectorXd& a) {
+    const int k = a.size();
+    Eigen::VectorXd aa(k*k);
+    for (int j = 0; j < k; j++)
+        aa.segment(j*k, k) = a(j) * a;
+    return aa;
+}
+
+void GalerkinROM::assembleReducedOperators(bool errorIndicator) {
+    ScopedTimer timer("assembly");
+    const Eigen::MatrixXd& Phi = pod_.basis();
+    const int k = Phi.cols();
+
+    Eigen::MatrixXd LapPhi(n_, k);
+    parallelFor(0, k, [&](int j) { LapPhi.col(j) = laplacian(Phi.col(j)); });
+    D_ = Phi.transpose() * LapPhi;
+
+    if (!errorIndicator) {
+        // One O(n) convection evaluation and one O(nk) projection per mode
+        // pair, with O(n) scratch
+        C_.resize(k, k*k);
+        parallelFor(0, k*k, [&](int jl) {
+            int j = jl / k, l = jl % k;
+            C_.col(jl) = Phi.transpose() * convection(Phi.col(j), Phi.col(l));
+        });
+        hasIndicator_ = false;
+    } else {
+        // The Gram matrices need every convection column at once
+        Eigen::MatrixXd N(n_, k*k);
+        parallelFor(0, k*k, [&](int jl) {
+            int j = jl / k, l = jl % k;
+            N.col(jl) = convection(Phi.col(j), Phi.col(l));
+        });
+        C_ = parallelTransposeMultiply(Phi, N);
+        Gll_ = LapPhi.transpose() * LapPhi;
+        Gln_ = parallelTransposeMultiply(LapPhi, N);
+        Gnn_ = parallelGram(N);
+        hasIndicator_ = true;
+    }
+    assembled_ = true;
+}
+
+double GalerkinROM::residualIndicator(const Eigen::VectorXd& a, const Eigen::VectorXd& rhs,
+                                      double* fullNorm) const
+{
+    if (!hasIndicator_)
+        throw std::runtime_error("GalerkinROM: error indicator not assembled");
+    // ||R(Phi a)||^2 = nu^2 a^T Gll a - 2 nu a^T Gln (a kron a)
+    //                + (a kron a)^T Gnn (a kron a)
+    Eigen::VectorXd aa = selfKron(a);
+    double r2 = nu_*nu_ * a.dot(Gll_ * a)
+              - 2.0*nu_ * a.dot(Gln_ * aa)
+              + aa.dot(Gnn_ * aa);
+    r2 = std::max(0.0, r2);
+    if (fullNorm)
+        *fullNorm = std::sqrt(r2);
+    // Pythagoras: the in-basis part of R is Phi rhs, with norm ||rhs||
+    return std::sqrt(std::max(0.0, r2 - rhs.squaredNorm()));
+}
+
+void GalerkinROM::saveOperators(const std::string& file) const {
+    if (!assembled_)
+        throw std::runtime_error("GalerkinROM::saveOperators: operators not assembled");
+    std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    std::int64_t header[2] = {D_.rows(), hasIndicator_ ? 1 : 0};
+    ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+    auto put = [&](const Eigen::MatrixXd& M) {
+        ofs.write(reinterpret_cast<const char*>(M.data()), M.size()*sizeof(double));
+    };
+    put(D_);
+    put(C_);
+    if (hasIndicator_) {
+        put(Gll_);
+        put(Gln_);
+        put(Gnn_);
+    }
+    if (!ofs)
+        throw std::runtime_error("Error writing " + file);
+    Instrumentation::count(Counter::BytesWritten, static_cast<std::int64_t>(ofs.tellp()));
+}
+
+void GalerkinROM::loadOperators(const std::string& file) {
+    std::ifstream ifs(file, std::ios::binary);
+    if (!ifs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    std::int64_t header[2] = {0, 0};
+    ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+    const std::int64_t k = header[0];
+    if (!ifs || k != pod_.basis().cols())
+        throw std::runtime_error("Operator file " + file + " does not match the basis");
+    auto get = [&](Eigen::MatrixXd& M, Eigen::Index rows, Eigen::Index cols) {
+        M.resize(rows, cols);
+        ifs.read(reinterpret_cast<char*>(M.data()), M.size()*sizeof(double));
+    };
+    get(D_, k, k);
+    get(C_, k, k*k);
+    hasIndicator_ = (header[1] != 0);
+    if (hasIndicator_) {
+        get(Gll_, k, k);
+        get(Gln_, k, k*k);
+        get(Gnn_, k*k, k*k);
+    }
+    if (!ifs)
+        throw std::runtime_error("Truncated operator file " + file);
+    Instrumentation::count(Counter::BytesRead, static_cast<std::int64_t>(ifs.tellg()));
+    assembled_ = true;
 }
 
 // compute \Phi^T * R(\Phi a)
 Eigen::VectorXd GalerkinROM::computeReducedRHS(const Eigen::VectorXd& a) {
+    if (assembled_)
+        return nu_ * (D_ * a) - C_ * selfKron(a);
     Eigen::VectorXd uFull = reconstructFull(a);
     Eigen::VectorXd Rfull = computeResidual(uFull);
     // project
     return pod_.basis().transpose() * Rfull;
 }
 
-Eigen::VectorXd GalerkinROM::stepExplicitEuler(const Eigen::VectorXd& a, double dt) {
-    Eigen::VectorXd rhs = computeReducedRHS(a);
-    return a + dt*rhs;
+Eigen::MatrixXd GalerkinROM::computeReducedRHSBatch(const Eigen::MatrixXd& A) {
+    Eigen::MatrixXd R, work;
+    computeReducedRHSBatch(A, R, work);
+    return R;
+}
+
+void GalerkinROM::computeReducedRHSBatch(const Eigen::Ref<const Eigen::MatrixXd>& A, Eigen::MatrixXd& R,
+                                         Eigen::MatrixXd& work) {
+    const int k = A.rows();
+    R.resize(k, A.cols());
+    if (!assembled_) {
+        for (Eigen::Index b = 0; b < A.cols(); b++)
+            R.col(b) = computeReducedRHS(A.col(b));
+        return;
+    }
+    // Column b of work is a_b kron a_b (see selfKron)
+    work.resize(k*k, A.cols());
+    for (Eigen::Index b = 0; b < A.cols(); b++)
+        for (int j = 0; j < k; j++)
+            work.col(b).segment(j*k, k) = A(j, b) * A.col(b);
+    R.noalias() = D_ * A;
+    R *= nu_;
+    R.noalias() -= C_ * work;
 }
 
 const POD& GalerkinROM::pod() const {
     return pod_;
 }
+
+double GalerkinROM::estimateFlopsPerStep(int Nx, int Ny, int k, bool assembled) {
+    if (assembled)
+        return 2.0*k*k*k + 3.0*k*k + 4.0*k;
+    double n = 2.0*Nx*Ny;
+    return 4.0*n*k + 18.0*n + 2.0*k;
+}
@@ -1,32 +1,97 @@
 #pragma once
 #include <Eigen/Dense>
+#include <string>
 #include <vector>
+#include "Field2D.h"
 #include "POD.h"
+#include "ReducedDynamics.h"
 
-class GalerkinROM {
+class GalerkinROM : public ReducedDynamics {
 public:
-    // constructor: pass the POD basis, domain sizes, etc. 
-    GalerkinROM(const POD& pod, int Nx, int Ny, double dx, double dy, double nu);
+    // constructor: pass the POD basis, domain sizes, etc. The boundary
+    // condition must match the one of the snapshots.
+    GalerkinROM(const POD& pod, int Nx, int Ny, double dx, double dy, double nu,
+                BoundaryCondition bc = BoundaryCondition::Dirichlet);
 
     // returns da/dt for a given a(t) in the reduced space
     // i.e. \Phi^T * R(\Phi a(t))
-    Eigen::VectorXd computeReducedRHS(const Eigen::VectorXd& a);
+    Eigen::VectorXd computeReducedRHS(const Eigen::VectorXd& a) override;
 
-    // build a function to do one step: a_{n+1} = a_n + dt * RHS
-    // (explicit Euler for demonstration)
-    Eigen::VectorXd stepExplicitEuler(const Eigen::VectorXd& a, double dt);
+    // Batched form for several reduced states (k x B): column b of the
+    // result is computeReducedRHS(A.col(b)). With assembled operators the
+    // products run as GEMMs over the whole batch.
+    Eigen::MatrixXd computeReducedRHSBatch(const Eigen::MatrixXd& A) override;
+    // In place; work holds the k^2 x B Kronecker products between calls
+    void computeReducedRHSBatch(const Eigen::Ref<const Eigen::MatrixXd>& A, Eigen::MatrixXd& R,
+                                Eigen::MatrixXd& work) override;
 
-    const POD& pod() const;
+    const POD& pod() const override;
+
+    // PDE residual in full dimension: R(uFull) => dimension n_
+    Eigen::VectorXd computeResidual(const Eigen::VectorXd& uFull);
+
+    // Precompute the reduced operators of the quadratic Burgers residual,
+    //   Phi^T R(Phi a) = nu * D a - C (a kron a),
+    // with D = Phi^T Lap Phi (k x k) and C(:, j*k+l) = Phi^T N(phi_j, phi_l)
+    // (k x k^2), N(w, u) = (w . grad) u. Costs O(n k^3) once; afterwards
+    // computeReducedRHS is O(k^3) with no full-dimensional work.
+    // Must be called again if the POD basis changes.
+    //
+    // With errorIndicator, also precompute the Gram matrices of the residual
+    // parts R(Phi a) = nu L a - N (a kron a), L = Lap Phi, N = [N(phi_j, phi_l)]:
+    // Gll = L^T L, Gln = L^T N, Gnn = N^T N. This needs n k^2 doubles of
+    // scratch and O(n k^4) flops once.
+    void assembleReducedOperators(bool errorIndicator = false);
+    bool assembled() const { return assembled_; }
+    bool hasErrorIndicator() const { return hasIndicator_; }
+
+    // A-posteriori error indicator, evaluated in reduced space in O(k^4):
+    // the part of the full-order residual the basis cannot represent,
+    //   ||R(Phi a) - Phi Phi^T R(Phi a)|| = sqrt(||R(Phi a)||^2 - ||rhs||^2),
+    // where rhs = computeReducedRHS(a). This is exactly the defect of
+    // x = Phi a in the full-order ODE, so its time integral drives the ROM
+    // error. fullNorm, if given, receives ||R(Phi a)||.
+    double residualIndicator(const Eigen::VectorXd& a, const Eigen::VectorXd& rhs,
+                             double* fullNorm = nullptr) const;
+
+    // Assembled operator I/O (binary: int64 k, int64 hasErrorIndicator,
+    // then D, C and, if present, Gll, Gln, Gnn, all column-major),
+    // so that prediction runs need not repeat the O(n k^3) assembly.
+    // loadOperators checks k against the current basis.
+    void saveOperators(const std::string& file) const;
+    void loadOperators(const std::string& file);
+
+    // Viscosity can change freely once operators are assembled (D does not
+    // depend on nu).
+    void setViscosity(double nu) { nu_ = nu; }
+    double viscosity() const { return nu_; }
+
+    // Predicted flops for one explicit Euler step with k modes on an
+    // Nx x Ny grid. Full path: reconstruct (2nk), full residual (~18n),
+    // project (2nk). Assembled: D a (2k^2), a kron a (k^2), C (2k^3).
+    static double estimateFlopsPerStep(int Nx, int Ny, int k, bool assembled = false);
 
 private:
     const POD& pod_;
     int Nx_, Ny_;
     double dx_, dy_, nu_;
+    BoundaryCondition bc_;
     int n_; // 2*Nx_*Ny_ for storing (u,v)
 
+    bool assembled_ = false;
+    Eigen::MatrixXd D_;  // k x k,   Phi^T Lap Phi
+    Eigen::MatrixXd C_;  // k x k^2, Phi^T N(phi_j, phi_l)
+
+    bool hasIndicator_ = false;
+    Eigen::MatrixXd Gll_;  // k x k
+    Eigen::MatrixXd Gln_;  // k x k^2
+    Eigen::MatrixXd Gnn_;  // k^2 x k^2
+
     // Reconstruct full vector from a
     Eigen::VectorXd reconstructFull(const Eigen::VectorXd& a);
 
-    // PDE residual in full dimension: R(uFull) => dimension n_
-    Eigen::VectorXd computeResidual(const Eigen::VectorXd& uFull);
+    // The two parts of the residual (zero on the boundary for Dirichlet):
+    // convection (w . grad) u and the discrete Laplacian of u
+    Eigen::VectorXd convection(const Eigen::VectorXd& w, const Eigen::VectorXd& u) const;
+    Eigen::VectorXd laplacian(const Eigen::VectorXd& u) const;
 };
@@ -0,0 +1,206 @@
+#include "GreedyTrainer.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include "Field2D.h"
+#include "GalerkinROM.h"
+#include "Instrumentation.h"
+#include "OfflineSolver2D.h"
+#include "POD.h"
+#include "Parallel.h"
+#include "Util.h"
+
+GreedySpec GreedySpec::fromTXT(const std::string& filename)
+{
+    std::ifstream ifs(filename);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Cannot open greedy spec file: " + filename);
+    }
+
+    GreedySpec spec;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(stripComment(line));
+        std::string key;
+        if (!(iss >> key))
+            continue;
+
+        auto readList = [&](std::vector<double>& values) {
+            double v;
+            while (iss >> v)
+                values.push_back(v);
+            if (values.empty())
+                throw std::runtime_error("Empty value list for " + key);
+        };
+
+        bool ok = true;
+        if (key == "viscosity")
+            readList(spec.viscosities);
+        else if (key == "swirlRadius")
+            readList(spec.swirlRadii);
+        else if (key == "swirlAmplitude")
+            readList(spec.swirlAmplitudes);
+        else if (key == "tolerance")
+            ok = static_cast<bool>(iss >> spec.tolerance);
+        else if (key == "maxSolves")
+            ok = static_cast<bool>(iss >> spec.maxSolves);
+        else if (key == "maxModes")
+            ok = static_cast<bool>(iss >> spec.maxModes);
+        else if (key == "energy")
+            ok = static_cast<bool>(iss >> spec.energy);
+        else if (key == "indicatorInterval")
+            ok = static_cast<bool>(iss >> spec.indicatorInterval);
+        else if (key == "threads")
+            ok = static_cast<bool>(iss >> spec.threads);
+        else if (key == "basis")
+            ok = static_cast<bool>(iss >> spec.basisFile);
+        else if (key == "log")
+            ok = static_cast<bool>(iss >> spec.logFile);
+        else
+            throw std::runtime_error("Unknown greedy key: " + key);
+        if (!ok)
+            throw std::runtime_error("Error reading " + key);
+    }
+    if (spec.maxSolves < 1 || spec.maxModes < 1 || spec.indicatorInterval < 1)
+        throw std::runtime_error("Greedy spec: maxSolves, maxModes and indicatorInterval must be >= 1");
+    return spec;
+}
+
+GreedyTrainer::GreedyTrainer(const Config& base, const GreedySpec& spec)
+    : base_(base), spec_(spec)
+{
+    auto orBase = [](const std::vector<double>& v, double base) {
+        return v.empty() ? std::vector<double>{base} : v;
+    };
+    for (double nu : orBase(spec_.viscosities, base_.viscosity)) {
+        for (double r : orBase(spec_.swirlRadii, base_.swirlRadius)) {
+            for (double a : orBase(spec_.swirlAmplitudes, base_.swirlAmplitude)) {
+                Config cfg = base_;
+                cfg.viscosity = nu;
+                cfg.swirlRadius = r;
+                cfg.swirlAmplitude = a;
+                candidates_.push_back(cfg);
+            }
+        }
+    }
+}
+
+// Error indicator of one candidate (see GreedyTrainer); rom is a private
+// copy, so candidates can be evaluated concurrently
+static double candidateIndicator(GalerkinROM rom, const Config& cfg, int interval) {
+    const Eigen::MatrixXd& Phi = rom.pod().basis();
+    OfflineSolver2D ic(cfg);
+    Eigen::VectorXd x0 = ic.initialState();
+    Eigen::VectorXd a = Phi.transpose() * x0;
+    double initial = (x0 - Phi*a).norm() / (x0.norm() + 1e-300);
+
+    rom.setViscosity(cfg.viscosity);
+    const int steps = static_cast<int>(std::ceil(cfg.finalTime/cfg.dt));
+    double integral = 0.0, scale = a.norm();
+    for (int s = 0; s < steps; s++) {
+        Eigen::VectorXd rhs = rom.computeReducedRHS(a);
+        if (s % interval == 0) {
+            integral += rom.residualIndicator(a, rhs) * std::min(interval, steps - s)*cfg.dt;
+            scale = std::max(scale, a.norm());
+        }
+        a += cfg.dt*rhs;
+        if (!a.allFinite())
+            return std::numeric_limits<double>::infinity();
+    }
+    return initial + integral / (scale + 1e-300);
+}
+
+void GreedyTrainer::run() {
+    ScopedTimer timer("greedyTrain");
+    const int M = numCandidates();
+    std::cout << "[GreedyTrainer] " << M << " candidates, at most "
+              << spec_.maxSolves << " full-order solves\n";
+
+    const double dx = base_.dx();
+    const double dy = base_.dy();
+    const BoundaryCondition bc = boundaryFromString(base_.boundary);
+    POD pod(spec_.maxModes, POD::methodFromString(base_.podMethod == "tsqr" ? "auto" : base_.podMethod));
+    pod.setRandomizedOptions(base_.podOversampling, base_.podPowerIterations, base_.podSeed);
+    pod.setEnergyThreshold(spec_.energy);
+    GalerkinROM rom(pod, base_.Nx, base_.Ny, dx, dy, base_.viscosity, bc);
+
+    Eigen::MatrixXd X;
+    std::vector<char> solved(M, 0);
+    std::vector<double> indicator(M, 0.0);
+    steps_.clear();
+
+    int next = 0;        // the first candidate seeds the basis
+    double worst = 0.0;
+    double evalSeconds = 0.0;
+    for (int it = 0; ; it++) {
+        // Expensive step: full-order solve at the chosen candidate
+        auto t0 = std::chrono::steady_clock::now();
+        OfflineSolver2D fom(candidates_[next]);
+        fom.simulate();
+        double solveSeconds = secondsSince(t0);
+        const auto& snaps = fom.snapshots();
+        Eigen::Index old = X.cols();
+        X.conservativeResize(snaps[0].size(), old + snaps.size());
+        for (std::size_t c = 0; c < snaps.size(); c++)
+            X.col(old + c) = snaps[c];
+        solved[next] = 1;
+
+        pod.computeBasis(X);
+        rom.assembleReducedOperators(true);
+
+        const Config& c = candidates_[next];
+        steps_.push_back({it, next, c.viscosity, c.swirlRadius, c.swirlAmplitude,
+                          it == 0 ? 0.0 : worst, pod.numModes(), static_cast<int>(X.cols()),
+                          solveSeconds, evalSeconds});
+        std::cout << "[GreedyTrainer] Solve " << it + 1 << ": candidate " << next
+                  << " (nu " << c.viscosity << ", radius " << c.swirlRadius
+                  << ", amplitude " << c.swirlAmplitude << "), k=" << pod.numModes() << "\n";
+
+        // Cheap step: indicator at every unsolved candidate, also after the
+        // last solve so that the final worst case is known
+        t0 = std::chrono::steady_clock::now();
+        parallelFor(0, M, [&](int m) {
+            indicator[m] = solved[m] ? 0.0
+                         : candidateIndicator(rom, candidates_[m], spec_.indicatorInterval);
+        }, spec_.threads);
+        evalSeconds = secondsSince(t0);
+
+        next = static_cast<int>(std::max_element(indicator.begin(), indicator.end()) - indicator.begin());
+        worst = indicator[next];
+        std::cout << "[GreedyTrainer] Worst indicator " << worst << " at candidate " << next
+                  << " (" << evalSeconds << " s for " << M << " candidates)\n";
+        if (worst <= spec_.tolerance || solved[next]
+            || static_cast<int>(steps_.size()) >= spec_.maxSolves)
+            break;
+    }
+
+    pod.saveBasis(spec_.basisFile);
+    rom.saveOperators(spec_.basisFile + ".ops");
+    writeLog(spec_.logFile);
+    int solves = static_cast<int>(steps_.size());
+    std::cout << "[GreedyTrainer] " << solves << " full-order solves for " << M
+              << " candidates (" << 100.0*solves/M << "%), worst indicator " << worst
+              << (worst <= spec_.tolerance ? " <= " : " > ") << "tolerance " << spec_.tolerance
+              << "; wrote " << pod.numModes() << "-mode basis to " << spec_.basisFile
+              << " and operators to " << spec_.basisFile << ".ops\n";
+}
+
+void GreedyTrainer::writeLog(const std::string& file) const {
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs.precision(8);
+    ofs << "iteration,candidate,viscosity,swirlRadius,swirlAmplitude,indicator,modes,snapshots,"
+           "solveSeconds,evalSeconds\n";
+    for (const auto& s : steps_) {
+        ofs << s.iteration << "," << s.candidate << "," << s.viscosity << "," << s.swirlRadius << ","
+            << s.swirlAmplitude << "," << s.indicator << "," << s.modes << "," << s.snapshots << ","
+            << s.solveSeconds << "," << s.evalSeconds << "\n";
+    }
+}
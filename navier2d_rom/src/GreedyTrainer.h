@@ -0,0 +1,86 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Config.h"
+
+// Greedy training description, in the same "key values..." format as the
+// sweep spec ('#' starts a comment):
+//
+//     viscosity       0.02 0.01 0.005 0.0025   # candidate values
+//     swirlRadius     0.15 0.2 0.25
+//     swirlAmplitude  0.5 1.0 1.5
+//     tolerance       1.0      # stop once every candidate's indicator is below
+//     maxSolves       10       # cap on full-order solves
+//     maxModes        20       # cap on the basis size
+//     energy          0.99999  # POD energy fraction kept from the snapshots
+//     indicatorInterval 10     # evaluate the residual every this many steps
+//     threads         0        # concurrent candidate evaluations (0 = numThreads())
+//     basis           greedy_basis.bin   # operators go to basis + ".ops"
+//     log             greedy.csv
+//
+// The candidate set is the Cartesian product of the parameter lists;
+// parameters that are not listed keep their value from the base Config.
+struct GreedySpec
+{
+    std::vector<double> viscosities;
+    std::vector<double> swirlRadii;
+    std::vector<double> swirlAmplitudes;
+
+    double tolerance = 1.0;
+    int maxSolves = 10;
+    int maxModes = 20;
+    double energy = 0.99999;
+    int indicatorInterval = 10;
+    int threads = 0;
+
+    std::string basisFile = "greedy_basis.bin";
+    std::string logFile = "greedy.csv";
+
+    static GreedySpec fromTXT(const std::string& filename);
+};
+
+// One greedy iteration: the candidate picked for a full-order solve
+struct GreedyStep
+{
+    int iteration;
+    int candidate;
+    double viscosity, swirlRadius, swirlAmplitude;
+    double indicator;   // its error indicator before the solve (0 for the seed)
+    int modes;          // basis size after adding its snapshots
+    int snapshots;      // snapshot columns collected so far
+    double solveSeconds, evalSeconds;
+};
+
+// Greedy reduced-basis training over the candidate parameters. The first
+// candidate seeds the basis; then every iteration evaluates a cheap error
+// indicator of the Galerkin ROM at every candidate (in parallel), runs
+// OfflineSolver2D only at the worst one, appends its snapshots, recomputes
+// the POD and reassembles the operators, until the worst indicator is
+// below the tolerance or a cap is hit.
+//
+// Indicator of a candidate: relative projection error of its initial
+// state plus the time integral of the reduced-space residual indicator
+// (GalerkinROM::residualIndicator) along its ROM trajectory, relative to
+// the largest ||a(t)||. This bounds the growth of the state error rather
+// than estimating it, so it over-predicts (the out-of-basis residual is
+// mostly grid-scale and quickly damped); the tolerance is on this scale.
+// A ROM that blows up scores infinity. Viscosity only rescales an
+// assembled operator, so no candidate needs any full-dimensional work.
+class GreedyTrainer {
+public:
+    GreedyTrainer(const Config& base, const GreedySpec& spec);
+
+    // Train and write the basis, the operators and the log
+    void run();
+
+    const std::vector<GreedyStep>& steps() const { return steps_; }
+    int numCandidates() const { return static_cast<int>(candidates_.size()); }
+
+    void writeLog(const std::string& file) const;
+
+private:
+    Config base_;
+    GreedySpec spec_;
+    std::vector<Config> candidates_;
+    std::vector<GreedyStep> steps_;
+};
@@ -0,0 +1,67 @@
+#include "HybridSolver2D.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "Instrumentation.h"
+
+HybridSolver2D::HybridSolver2D(const Config& cfg, POD& pod, GalerkinROM& rom)
+    : cfg_(cfg), pod_(pod), rom_(rom), fom_(cfg)
+{
+    if (!rom_.hasErrorIndicator())
+        rom_.assembleReducedOperators(true);
+}
+
+Eigen::VectorXd HybridSolver2D::run(const Eigen::VectorXd& initialFull) {
+    ScopedTimer timer("hybrid");
+    romSteps_ = fomSteps_ = fallbacks_ = modesAdded_ = 0;
+    const double dt = cfg_.dt;
+    const int steps = static_cast<int>(std::ceil(cfg_.finalTime/dt));
+    const int fomBurst = std::max(1, cfg_.hybridFomSteps);
+
+    Eigen::VectorXd a = pod_.basis().transpose() * initialFull;
+    Eigen::VectorXd fomFinal;  // set if the run ends inside a full-order burst
+    int s = 0;
+    while (s < steps) {
+        Eigen::VectorXd rhs = rom_.computeReducedRHS(a);
+        double fullNorm = 0.0;
+        double res = rom_.residualIndicator(a, rhs, &fullNorm);
+        double relative = res / (fullNorm + 1e-300);
+
+        if (relative <= cfg_.hybridThreshold) {
+            a += dt*rhs;
+            s++;
+            romSteps_++;
+            Instrumentation::count(Counter::Steps);
+            continue;
+        }
+
+        // Out of the training regime: lift, run the full model for a burst
+        // of steps, then come back to the (possibly enriched) basis.
+        fallbacks_++;
+        int burst = std::min(fomBurst, steps - s);
+        fom_.setState(pod_.basis() * a);
+        Eigen::MatrixXd newSnaps(initialFull.size(), burst);
+        for (int b = 0; b < burst; b++) {
+            fom_.advance(1);
+            newSnaps.col(b) = fom_.state();
+        }
+        s += burst;
+        fomSteps_ += burst;
+        if (s >= steps)
+            fomFinal = newSnaps.col(burst - 1);
+
+        if (cfg_.hybridEnrich) {
+            int added = pod_.enrich(newSnaps, 1e-3, cfg_.hybridMaxModes);
+            if (added > 0) {
+                modesAdded_ += added;
+                rom_.assembleReducedOperators(true);
+            }
+        }
+        a = pod_.basis().transpose() * newSnaps.col(burst - 1);
+    }
+
+    std::cout << "[HybridSolver2D] " << romSteps_ << " ROM steps, " << fomSteps_
+              << " full-order steps in " << fallbacks_ << " fallbacks, "
+              << modesAdded_ << " modes added (k=" << pod_.numModes() << ")\n";
+    return fomFinal.size() > 0 ? fomFinal : Eigen::VectorXd(pod_.basis() * a);
+}
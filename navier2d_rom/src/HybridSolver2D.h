@@ -0,0 +1,34 @@
+#pragma once
+#include <Eigen/Dense>
+#include "Config.h"
+#include "GalerkinROM.h"
+#include "OfflineSolver2D.h"
+#include "POD.h"
+
+// Adaptive ROM/full-order driver. The reduced model advances while its
+// relative error indicator (GalerkinROM::residualIndicator / ||R||) stays
+// below cfg.hybridThreshold. When it is crossed, the state is lifted to
+// full dimension, advanced cfg.hybridFomSteps steps with OfflineSolver2D,
+// optionally used to enrich the basis (cfg.hybridEnrich), and projected
+// back to continue with the ROM.
+class HybridSolver2D {
+public:
+    // rom must be built on pod; pod is modified when enrichment is enabled.
+    HybridSolver2D(const Config& cfg, POD& pod, GalerkinROM& rom);
+
+    // Run from a full initial state to cfg.finalTime; returns the final full state
+    Eigen::VectorXd run(const Eigen::VectorXd& initialFull);
+
+    int romSteps() const { return romSteps_; }
+    int fomSteps() const { return fomSteps_; }
+    int fallbacks() const { return fallbacks_; }
+    int modesAdded() const { return modesAdded_; }
+
+private:
+    Config cfg_;
+    POD& pod_;
+    GalerkinROM& rom_;
+    OfflineSolver2D fom_;
+
+    int romSteps_ = 0, fomSteps_ = 0, fallbacks_ = 0, modesAdded_ = 0;
+};
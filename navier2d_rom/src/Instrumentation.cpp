@@ -0,0 +1,290 @@
+#include "Instrumentation.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <sys/resource.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kNumCounters = 4;
+const char* const kCounterNames[kNumCounters] = {"steps", "operatorNewCalls",
+                                                 "bytesRead", "bytesWritten"};
+
+struct ScopeNode {
+    const char* name;
+    std::int64_t calls = 0;
+    double seconds = 0.0;
+    bool stage = false;
+    long peakRssKB = 0;     // stage scopes only
+    long rssGrowthKB = 0;   // RSS at exit minus RSS at entry, summed over calls
+    std::int64_t counters[kNumCounters] = {};
+    std::vector<std::unique_ptr<ScopeNode>> children;
+
+    explicit ScopeNode(const char* n) : name(n) {}
+
+    ScopeNode* child(const char* n) {
+        for (auto& c : children)
+            if (c->name == n || std::strcmp(c->name, n) == 0)
+                return c.get();
+        children.push_back(std::make_unique<ScopeNode>(n));
+        return children.back().get();
+    }
+};
+
+struct Frame {
+    ScopeNode* node;
+    Clock::time_point start;
+    std::int64_t counters[kNumCounters];
+    bool stage;
+    long entryRssKB;
+    long peakRssKB;    // largest peak seen by stages nested in this one
+};
+
+struct ThreadData {
+    int index;
+    ScopeNode root{"thread"};
+    std::vector<Frame> stack;
+    std::int64_t counters[kNumCounters] = {};
+
+    explicit ThreadData(int i) : index(i) {}
+};
+
+std::mutex g_mutex;
+std::vector<ThreadData*> g_live;
+ThreadData g_retired(-1);
+int g_nextIndex = 0;
+Clock::time_point g_start = Clock::now();
+// Largest stage peak so far: the kernel mark restarts at every stage
+std::atomic<long> g_peakKB{0};
+
+void merge(ScopeNode& dst, const ScopeNode& src) {
+    dst.calls += src.calls;
+    dst.seconds += src.seconds;
+    dst.stage = dst.stage || src.stage;
+    dst.peakRssKB = std::max(dst.peakRssKB, src.peakRssKB);
+    dst.rssGrowthKB += src.rssGrowthKB;
+    for (int c = 0; c < kNumCounters; c++)
+        dst.counters[c] += src.counters[c];
+    for (const auto& child : src.children)
+        merge(*dst.child(child->name), *child);
+}
+
+void mergeThread(ThreadData& dst, const ThreadData& src) {
+    merge(dst.root, src.root);
+    for (int c = 0; c < kNumCounters; c++)
+        dst.counters[c] += src.counters[c];
+}
+
+// Owns the calling thread's data; folds it into g_retired on thread exit
+struct ThreadSlot {
+    ThreadData* data = nullptr;
+    ~ThreadSlot() {
+        if (!data)
+            return;
+        std::lock_guard<std::mutex> lock(g_mutex);
+        mergeThread(g_retired, *data);
+        g_live.erase(std::find(g_live.begin(), g_live.end(), data));
+        delete data;
+        data = nullptr;
+    }
+};
+
+thread_local ThreadSlot t_slot;
+// Set while the hooks below run, so allocations they make are not counted
+thread_local bool t_inHook = false;
+
+struct HookGuard {
+    HookGuard() { t_inHook = true; }
+    ~HookGuard() { t_inHook = false; }
+};
+
+ThreadData& threadData() {
+    if (!t_slot.data) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        t_slot.data = new ThreadData(g_nextIndex++);
+        g_live.push_back(t_slot.data);
+    }
+    return *t_slot.data;
+}
+
+// "VmRSS:" or "VmHWM:" of /proc/self/status in kB, -1 if unavailable
+long procStatusKB(const char* key) {
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    const std::size_t len = std::strlen(key);
+    while (std::getline(ifs, line))
+        if (line.compare(0, len, key) == 0)
+            return std::atol(line.c_str() + len);
+    return -1;
+}
+
+// Innermost open stage of the thread, or nullptr
+Frame* openStage(ThreadData& td) {
+    for (auto it = td.stack.rbegin(); it != td.stack.rend(); ++it)
+        if (it->stage)
+            return &*it;
+    return nullptr;
+}
+
+void writeCounters(std::ostream& os, const std::int64_t* counters) {
+    os << "{";
+    for (int c = 0; c < kNumCounters; c++)
+        os << (c ? ", " : "") << "\"" << kCounterNames[c] << "\": " << counters[c];
+    os << "}";
+}
+
+void writeScopes(std::ostream& os, const ScopeNode& node, const std::string& indent) {
+    os << "[";
+    for (std::size_t i = 0; i < node.children.size(); i++) {
+        const ScopeNode& c = *node.children[i];
+        double childSeconds = 0.0;
+        for (const auto& cc : c.children)
+            childSeconds += cc->seconds;
+        os << (i ? "," : "") << "\n" << indent << "  {\"name\": \"" << c.name << "\""
+           << ", \"calls\": " << c.calls
+           << ", \"seconds\": " << c.seconds
+           << ", \"selfSeconds\": " << c.seconds - childSeconds;
+        if (c.stage)
+            os << ", \"peakRssKB\": " << c.peakRssKB << ", \"rssGrowthKB\": " << c.rssGrowthKB;
+        os << ", \"counters\": ";
+        writeCounters(os, c.counters);
+        os << ", \"children\": ";
+        writeScopes(os, c, indent + "  ");
+        os << "}";
+    }
+    if (!node.children.empty())
+        os << "\n" << indent;
+    os << "]";
+}
+
+} // namespace
+
+long Instrumentation::currentRssKB() {
+    return std::max(0L, procStatusKB("VmRSS:"));
+}
+
+long Instrumentation::peakRssKB() {
+    long hwm = procStatusKB("VmHWM:");
+    if (hwm >= 0)
+        return hwm;
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // kilobytes on Linux
+}
+
+bool Instrumentation::resetPeakRss() {
+    std::ofstream ofs("/proc/self/clear_refs");
+    return static_cast<bool>(ofs << "5" << std::flush);
+}
+
+void Instrumentation::enable(bool on) {
+    if (on)
+        g_start = Clock::now();
+    enabled_.store(on, std::memory_order_relaxed);
+}
+
+void Instrumentation::add(Counter c, std::int64_t n) {
+    if (t_inHook)
+        return;
+    HookGuard guard;
+    threadData().counters[static_cast<int>(c)] += n;
+}
+
+void Instrumentation::begin(const char* name, bool stage) {
+    Frame* f;
+    {
+        HookGuard guard;
+        ThreadData& td = threadData();
+        long entryRssKB = 0;
+        if (stage) {
+            // Keep the enclosing stage's peak before the mark restarts
+            if (Frame* outer = openStage(td))
+                outer->peakRssKB = std::max(outer->peakRssKB, peakRssKB());
+            resetPeakRss();
+            entryRssKB = currentRssKB();
+        }
+        ScopeNode* parent = td.stack.empty() ? &td.root : td.stack.back().node;
+        td.stack.push_back(Frame{parent->child(name), {}, {}, stage, entryRssKB, 0});
+        f = &td.stack.back();
+        std::memcpy(f->counters, td.counters, sizeof(f->counters));
+    }
+    f->start = Clock::now();
+}
+
+void Instrumentation::end() {
+    auto stop = Clock::now();
+    HookGuard guard;
+    ThreadData& td = threadData();
+    if (!td.stack.empty()) {
+        Frame f = td.stack.back();
+        td.stack.pop_back();
+        ScopeNode& node = *f.node;
+        node.calls++;
+        node.seconds += std::chrono::duration<double>(stop - f.start).count();
+        if (f.stage) {
+            long peak = std::max(f.peakRssKB, peakRssKB());
+            node.stage = true;
+            node.peakRssKB = std::max(node.peakRssKB, peak);
+            node.rssGrowthKB += currentRssKB() - f.entryRssKB;
+            if (Frame* outer = openStage(td))
+                outer->peakRssKB = std::max(outer->peakRssKB, peak);
+            if (peak > g_peakKB.load())
+                g_peakKB.store(peak);
+        }
+        for (int c = 0; c < kNumCounters; c++)
+            node.counters[c] += td.counters[c] - f.counters[c];
+    }
+}
+
+void Instrumentation::writeReport(std::ostream& os) {
+    HookGuard guard;
+    std::lock_guard<std::mutex> lock(g_mutex);
+    ThreadData total(-1);
+    for (const ThreadData* td : g_live)
+        mergeThread(total, *td);
+    mergeThread(total, g_retired);
+
+    os << "{\n"
+       << "  \"wallSeconds\": " << std::chrono::duration<double>(Clock::now() - g_start).count() << ",\n"
+       << "  \"peakRssKB\": " << std::max(g_peakKB.load(), peakRssKB()) << ",\n"
+       << "  \"note\": \"operatorNewCalls counts global operator new only; Eigen matrix "
+          "storage is allocated with malloc and is not included\",\n"
+       << "  \"counters\": ";
+    writeCounters(os, total.counters);
+    os << ",\n  \"scopes\": ";
+    writeScopes(os, total.root, "  ");
+    os << ",\n  \"threads\": [";
+
+    std::vector<const ThreadData*> threads(g_live.begin(), g_live.end());
+    threads.push_back(&g_retired);
+    for (std::size_t i = 0; i < threads.size(); i++) {
+        const ThreadData& td = *threads[i];
+        os << (i ? "," : "") << "\n    {\"thread\": ";
+        if (td.index < 0)
+            os << "\"retired\"";
+        else
+            os << td.index;
+        os << ", \"counters\": ";
+        writeCounters(os, td.counters);
+        os << ", \"scopes\": ";
+        writeScopes(os, td.root, "    ");
+        os << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+void Instrumentation::writeReport(const std::string& file) {
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    writeReport(ofs);
+}
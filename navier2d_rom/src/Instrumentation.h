@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Run instrumentation: nested scoped timers and per-thread counters,
+// written as a JSON report. Disabled by default; while disabled, a timer
+// or counter costs one relaxed atomic load.
+//
+//   {
+//       ScopedTimer t("svd");
+//       ...
+//       Instrumentation::count(Counter::BytesRead, bytes);
+//   }
+//
+// Scopes nest per thread: a scope opened inside "train" on the same thread
+// is reported as a child of "train". Scopes opened on worker threads start
+// a new tree for that thread; when a worker exits, its tree and counters
+// are merged into a shared "retired" entry so short-lived parallelFor
+// workers do not each get their own record.
+//
+// Memory is sampled only by stage scopes (ScopedTimer(name, true), the
+// pipeline stages): each records the resident set growth from entry to
+// exit and its own peak RSS. On Linux the kernel high-water mark is reset
+// when a stage opens (/proc/self/clear_refs), so the peak belongs to that
+// stage rather than to the whole process; an enclosing stage still gets
+// the largest peak of its nested ones. Stages are opened from one thread
+// at a time.
+
+enum class Counter { Steps, OperatorNewCalls, BytesRead, BytesWritten };
+
+class Instrumentation {
+public:
+    // Turning instrumentation on (re)starts the report's wall clock
+    static void enable(bool on = true);
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Add n to a counter of the calling thread and its open scopes.
+    // OperatorNewCalls is counted automatically in the executables (global
+    // operator new, see AllocationHooks.cpp). Eigen allocates matrix storage
+    // with malloc, so it is not included.
+    static void count(Counter c, std::int64_t n = 1) {
+        if (enabled())
+            add(c, n);
+    }
+
+    // JSON report: wall time, process peak RSS, counter totals, the merged
+    // scope tree, and the tree and counters of every thread. Call it while
+    // no worker thread is running.
+    static void writeReport(std::ostream& os);
+    static void writeReport(const std::string& file);
+
+    // Resident set size now and its high-water mark since the last
+    // resetPeakRss (or process start), in kilobytes. Without /proc the
+    // current size is 0 and the peak is getrusage's process maximum.
+    static long currentRssKB();
+    static long peakRssKB();
+    // Restart the high-water mark at the current RSS; false where the
+    // system cannot (the peak then stays the process maximum)
+    static bool resetPeakRss();
+
+private:
+    friend class ScopedTimer;
+    static void add(Counter c, std::int64_t n);
+    static void begin(const char* name, bool stage);
+    static void end();
+
+    static inline std::atomic<bool> enabled_{false};
+};
+
+// Times the enclosing block as a child of the thread's current scope; a
+// stage scope also samples memory (see Instrumentation). name must outlive
+// the program (a string literal).
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name, bool stage = false)
+        : active_(Instrumentation::enabled()) {
+        if (active_)
+            Instrumentation::begin(name, stage);
+    }
+    ~ScopedTimer() {
+        if (active_)
+            Instrumentation::end();
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    bool active_;
+};
@@ -0,0 +1,152 @@
+#include "LocalGalerkinROM.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include "Instrumentation.h"
+#include "ParallelLinAlg.h"
+
+LocalGalerkinROM::LocalGalerkinROM(const Config& cfg, int numClusters)
+    : cfg_(cfg), K_(numClusters)
+{
+    if (K_ < 1)
+        throw std::runtime_error("LocalGalerkinROM needs at least one cluster");
+}
+
+// Lloyd iterations with k-means++ seeding (fixed seed for reproducibility).
+// Distances use ||x||^2 - 2 mu^T x + ||mu||^2 so each sweep is one GEMM.
+// A cluster left empty is re-seeded with the snapshot farthest from its
+// centre, so every cluster ends up with members and a basis.
+std::vector<int> LocalGalerkinROM::kmeans(const Eigen::MatrixXd& X) {
+    const Eigen::Index n = X.rows(), m = X.cols();
+    Eigen::VectorXd xNorm2 = X.colwise().squaredNorm().transpose();
+    std::mt19937_64 rng(cfg_.podSeed);
+
+    centres_.resize(n, K_);
+    std::vector<double> d2(m, std::numeric_limits<double>::max());
+    int first = std::uniform_int_distribution<int>(0, m-1)(rng);
+    centres_.col(0) = X.col(first);
+    for (int c = 1; c < K_; c++) {
+        for (Eigen::Index j = 0; j < m; j++)
+            d2[j] = std::min(d2[j], (X.col(j) - centres_.col(c-1)).squaredNorm());
+        std::discrete_distribution<int> pick(d2.begin(), d2.end());
+        centres_.col(c) = X.col(pick(rng));
+    }
+
+    std::vector<int> assign(m, -1);
+    std::vector<double> dist(m);
+    for (int iter = 0; iter < 100; iter++) {
+        Eigen::MatrixXd cross = parallelTransposeMultiply(centres_, X); // K x m
+        Eigen::VectorXd cNorm2 = centres_.colwise().squaredNorm().transpose();
+        bool changed = false;
+        for (Eigen::Index j = 0; j < m; j++) {
+            int best = 0;
+            double bestD = std::numeric_limits<double>::max();
+            for (int c = 0; c < K_; c++) {
+                double d = xNorm2(j) - 2*cross(c, j) + cNorm2(c);
+                if (d < bestD) { bestD = d; best = c; }
+            }
+            changed |= (assign[j] != best);
+            assign[j] = best;
+            dist[j] = bestD;
+        }
+
+        std::vector<int> count(K_, 0);
+        for (Eigen::Index j = 0; j < m; j++)
+            count[assign[j]]++;
+        for (int c = 0; c < K_; c++) {
+            if (count[c] > 0)
+                continue;
+            // m >= K_, so some cluster has a member to spare
+            Eigen::Index far = -1;
+            for (Eigen::Index j = 0; j < m; j++)
+                if (count[assign[j]] > 1 && (far < 0 || dist[j] > dist[far]))
+                    far = j;
+            count[assign[far]]--;
+            assign[far] = c;
+            count[c] = 1;
+            dist[far] = 0.0;
+            changed = true;
+        }
+        if (!changed)
+            break;
+
+        Eigen::MatrixXd sum = Eigen::MatrixXd::Zero(n, K_);
+        for (Eigen::Index j = 0; j < m; j++)
+            sum.col(assign[j]) += X.col(j);
+        for (int c = 0; c < K_; c++)
+            centres_.col(c) = sum.col(c) / count[c];
+    }
+    return assign;
+}
+
+void LocalGalerkinROM::train(const Eigen::MatrixXd& X) {
+    ScopedTimer timer("localTraining");
+    if (X.cols() < K_)
+        throw std::runtime_error("LocalGalerkinROM: fewer snapshots than clusters");
+    std::vector<int> assign = kmeans(X);
+    centreNorm2_ = centres_.colwise().squaredNorm().transpose();
+
+    double dx = cfg_.dx();
+    double dy = cfg_.dy();
+    // Cluster snapshot sets are held in memory, so "tsqr" falls back to auto.
+    POD::Method method = (cfg_.podMethod == "tsqr") ? POD::Method::Auto
+                                                   : POD::methodFromString(cfg_.podMethod);
+
+    clusters_.clear();
+    for (int c = 0; c < K_; c++) {
+        // Members plus their temporal neighbours, so that adjacent local
+        // bases overlap and the state survives a basis switch.
+        std::vector<int> cols;
+        for (int j = 0; j < X.cols(); j++) {
+            bool near = assign[j] == c
+                     || (j > 0 && assign[j-1] == c)
+                     || (j+1 < X.cols() && assign[j+1] == c);
+            if (near)
+                cols.push_back(j);
+        }
+        Eigen::MatrixXd Xc(X.rows(), cols.size());
+        for (std::size_t i = 0; i < cols.size(); i++)
+            Xc.col(i) = X.col(cols[i]);
+
+        auto cl = std::make_unique<Cluster>(cfg_.numPodModes, method);
+        cl->pod.setRandomizedOptions(cfg_.podOversampling, cfg_.podPowerIterations, cfg_.podSeed);
+        cl->pod.setEnergyThreshold(cfg_.podEnergy);
+        cl->pod.computeBasis(Xc);
+        cl->rom = std::make_unique<GalerkinROM>(cl->pod, cfg_.Nx, cfg_.Ny, dx, dy, cfg_.viscosity,
+                                                boundaryFromString(cfg_.boundary));
+        cl->rom->assembleReducedOperators();
+        cl->centreProj = cl->pod.basis().transpose() * centres_;
+        std::cout << "[LocalGalerkinROM] cluster " << c << ": " << cols.size()
+                  << " snapshots, k=" << cl->pod.numModes() << "\n";
+        clusters_.push_back(std::move(cl));
+    }
+
+    transitions_.assign(K_, std::vector<Eigen::MatrixXd>(K_));
+    for (int a = 0; a < K_; a++)
+        for (int b = 0; b < K_; b++)
+            if (a != b)
+                transitions_[a][b] = basis(b).transpose() * basis(a);
+}
+
+int LocalGalerkinROM::nearestCluster(const Eigen::Ref<const Eigen::VectorXd>& x) const {
+    Eigen::VectorXd d2 = centreNorm2_ - 2.0 * (centres_.transpose() * x);
+    int best;
+    d2.minCoeff(&best);
+    return best;
+}
+
+int LocalGalerkinROM::nearestCluster(int c, const Eigen::VectorXd& a) const {
+    // ||a||^2 is common to all clusters and drops out of the comparison
+    Eigen::VectorXd d2 = centreNorm2_ - 2.0 * (clusters_[c]->centreProj.transpose() * a);
+    int best;
+    d2.minCoeff(&best);
+    return best;
+}
+
+Eigen::VectorXd LocalGalerkinROM::transition(int from, int to, const Eigen::VectorXd& a) const {
+    if (from == to)
+        return a;
+    return transitions_[from][to] * a;
+}
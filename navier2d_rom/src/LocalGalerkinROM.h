@@ -0,0 +1,54 @@
+#pragma once
+#include <Eigen/Dense>
+#include <memory>
+#include <vector>
+#include "Config.h"
+#include "GalerkinROM.h"
+#include "POD.h"
+
+// Localized (clustered) Galerkin ROM: the snapshot columns are split into
+// regions by k-means, and each region gets its own small POD basis and
+// assembled reduced operators. Online, the state is advanced in one local
+// basis and moved to another (through the precomputed k_b x k_a transition
+// map Phi_b^T Phi_a) when a different cluster centre becomes the nearest.
+class LocalGalerkinROM {
+public:
+    // numClusters regions, each with cfg.numPodModes modes (or fewer with
+    // cfg.podEnergy), built with cfg.podMethod.
+    LocalGalerkinROM(const Config& cfg, int numClusters);
+
+    // Cluster the snapshot columns of X (n x m) and build the local models
+    void train(const Eigen::MatrixXd& X);
+
+    int numClusters() const { return static_cast<int>(clusters_.size()); }
+    GalerkinROM& rom(int c) { return *clusters_[c]->rom; }
+    const Eigen::MatrixXd& basis(int c) const { return clusters_[c]->pod.basis(); }
+
+    // Nearest cluster to a full state (O(n K), used once at start-up)
+    int nearestCluster(const Eigen::Ref<const Eigen::VectorXd>& x) const;
+
+    // Nearest cluster to the state Phi_c a, evaluated in reduced
+    // coordinates: ||Phi_c a - mu_i||^2 = ||a||^2 - 2 a^T (Phi_c^T mu_i) + ||mu_i||^2,
+    // i.e. O(k K) per call.
+    int nearestCluster(int c, const Eigen::VectorXd& a) const;
+
+    // Coordinates of Phi_from a in the basis of cluster `to`
+    Eigen::VectorXd transition(int from, int to, const Eigen::VectorXd& a) const;
+
+private:
+    struct Cluster {
+        explicit Cluster(int numModes, POD::Method method) : pod(numModes, method) {}
+        POD pod;
+        std::unique_ptr<GalerkinROM> rom;  // refers to pod, so Cluster never moves
+        Eigen::MatrixXd centreProj;        // k_c x K, Phi_c^T mu_i
+    };
+
+    Config cfg_;
+    int K_;
+    Eigen::MatrixXd centres_;              // n x K
+    Eigen::VectorXd centreNorm2_;          // ||mu_i||^2
+    std::vector<std::unique_ptr<Cluster>> clusters_;
+    std::vector<std::vector<Eigen::MatrixXd>> transitions_;  // [from][to]
+
+    std::vector<int> kmeans(const Eigen::MatrixXd& X);
+};
@@ -0,0 +1,65 @@
+#include "ModelRegistry.h"
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include "DMDROM.h"
+#include "GalerkinModel.h"
+#include "OperatorInferenceROM.h"
+
+struct RegistryState {
+    std::mutex mutex;
+    std::map<std::string, ModelRegistry::Factory> factories;
+};
+
+// Built-ins are added on first use rather than by static initializers,
+// which the linker may drop from a static library
+static RegistryState& registry() {
+    static RegistryState r;
+    static std::once_flag builtins;
+    std::call_once(builtins, [] {
+        r.factories["galerkin"] = [](const Config& cfg) {
+            return std::unique_ptr<ReducedOrderModel>(new GalerkinModel(cfg));
+        };
+        r.factories["opinf"] = [](const Config& cfg) {
+            return std::unique_ptr<ReducedOrderModel>(new OperatorInferenceROM(cfg));
+        };
+        r.factories["dmd"] = [](const Config& cfg) {
+            return std::unique_ptr<ReducedOrderModel>(new DMDROM(cfg));
+        };
+    });
+    return r;
+}
+
+void ModelRegistry::add(const std::string& name, Factory factory) {
+    RegistryState& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.factories[name] = std::move(factory);
+}
+
+bool ModelRegistry::has(const std::string& name) {
+    RegistryState& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.factories.count(name) != 0;
+}
+
+std::vector<std::string> ModelRegistry::names() {
+    RegistryState& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<std::string> out;
+    for (const auto& f : r.factories)
+        out.push_back(f.first);
+    return out;
+}
+
+std::unique_ptr<ReducedOrderModel> ModelRegistry::create(const std::string& name, const Config& cfg) {
+    Factory factory;
+    {
+        RegistryState& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto it = r.factories.find(name);
+        if (it == r.factories.end())
+            throw std::runtime_error("Unknown reduced model: " + name);
+        factory = it->second;
+    }
+    return factory(cfg);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Config.h"
+#include "ReducedOrderModel.h"
+
+// Factories of ReducedOrderModel implementations keyed by name, the
+// romType of the config. "galerkin", "opinf" and "dmd" are built in;
+// further models register themselves with add() before the config is
+// loaded, and are then selected and run by the pipeline stages without
+// changes there.
+class ModelRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<ReducedOrderModel>(const Config&)>;
+
+    // Register (or replace) a model
+    static void add(const std::string& name, Factory factory);
+
+    static bool has(const std::string& name);
+    static std::vector<std::string> names();
+
+    // Untrained model configured from cfg; throws for unknown names
+    static std::unique_ptr<ReducedOrderModel> create(const std::string& name, const Config& cfg);
+};
@@ -1,7 +1,11 @@
 #include "OfflineSolver2D.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include "Instrumentation.h"
 
 OfflineSolver2D::OfflineSolver2D(const Config& cfg)
     : cfg_(cfg)
@@ -10,38 +14,42 @@ OfflineSolver2D::OfflineSolver2D(const Config& cfg)
     Ny_ = cfg_.Ny;
     Lx_ = cfg_.Lx;
     Ly_ = cfg_.Ly;
-    dx_ = Lx_ / (Nx_ - 1);
-    dy_ = Ly_ / (Ny_ - 1);
+    dx_ = cfg_.dx();
+    dy_ = cfg_.dy();
 
     dt_ = cfg_.dt;
     finalTime_ = cfg_.finalTime;
     nu_ = cfg_.viscosity;
     snapshotInterval_ = cfg_.snapshotInterval;
     snapshotFile_ = cfg_.snapshotFile;
-
-    u_.resize(Nx_*Ny_, 0.0);
-    v_.resize(Nx_*Ny_, 0.0);
-    uNext_.resize(Nx_*Ny_, 0.0);
-    vNext_.resize(Nx_*Ny_, 0.0);
+    bc_ = boundaryFromString(cfg_.boundary);
+
+    u_ = Field2D(Nx_, Ny_);
+    v_ = Field2D(Nx_, Ny_);
+    uNext_ = Field2D(Nx_, Ny_);
+    vNext_ = Field2D(Nx_, Ny_);
+    Ru_.resize(Nx_);
+    Rv_.resize(Nx_);
 }
 
 void OfflineSolver2D::initialize() {
+    time_ = 0.0;
+    stepCount_ = 0;
     // e.g. a shear flow or random init
     // let's do something like: u(x,0)=1 at top boundary, rest=0
     // or a "swirl" in the domain
     for(int j=0; j<Ny_; j++){
         for(int i=0; i<Nx_; i++){
-            int id=idx(i,j);
             double x = i*dx_;
             double y = j*dy_;
             // For example, a circular swirl
             double r2 = (x-0.5*Lx_)*(x-0.5*Lx_) + (y-0.5*Ly_)*(y-0.5*Ly_);
-            if(r2 < 0.05) {
-                u_[id] = 1.0;
-                v_[id] = 1.0;
+            if(r2 < cfg_.swirlRadius*cfg_.swirlRadius) {
+                u_(i,j) = cfg_.swirlAmplitude;
+                v_(i,j) = cfg_.swirlAmplitude;
             } else {
-                u_[id] = 0.0;
-                v_[id] = 0.0;
+                u_(i,j) = 0.0;
+                v_(i,j) = 0.0;
             }
         }
     }
@@ -50,86 +58,105 @@ void OfflineSolver2D::initialize() {
 // Single explicit time step
 // PDE: du/dt = - (u du/dx + v du/dy) + nu (d^2u/dx^2 + d^2u/dy^2)
 void OfflineSolver2D::stepExplicit() {
-    // We'll do central differences for spatial deriv
-    auto lap = [&](const std::vector<double>& phi, int i, int j){
-        double left   = phi[idx(i-1,j)];
-        double right  = phi[idx(i+1,j)];
-        double up     = phi[idx(i,j+1)];
-        double down   = phi[idx(i,j-1)];
-        double center = phi[idx(i,j)];
-        double d2x = (left - 2*center + right)/(dx_*dx_);
-        double d2y = (down - 2*center + up   )/(dy_*dy_);
-        return d2x + d2y;
-    };
-
-    auto dudx = [&](int i, int j){
-        double left  = u_[idx(i-1,j)];
-        double right = u_[idx(i+1,j)];
-        return (right - left)/(2*dx_);
-    };
-    auto dudy = [&](int i, int j){
-        double down = u_[idx(i,j-1)];
-        double up   = u_[idx(i,j+1)];
-        return (up - down)/(2*dy_);
-    };
-    auto dvdx = [&](int i, int j){
-        double left  = v_[idx(i-1,j)];
-        double right = v_[idx(i+1,j)];
-        return (right - left)/(2*dx_);
-    };
-    auto dvdy = [&](int i, int j){
-        double down = v_[idx(i,j-1)];
-        double up   = v_[idx(i,j+1)];
-        return (up - down)/(2*dy_);
-    };
-
-    // We'll ignore boundary conditions for now or set them to zero
-    for(int j=1; j<Ny_-1; j++){
-        for(int i=1; i<Nx_-1; i++){
-            int id=idx(i,j);
-            double convU = u_[id]*dudx(i,j) + v_[id]*dudy(i,j);
-            double convV = u_[id]*dvdx(i,j) + v_[id]*dvdy(i,j);
-
-            double lapU = lap(u_,i,j);
-            double lapV = lap(v_,i,j);
-
-            // PDE step
-            uNext_[id] = u_[id] + dt_*( -convU + nu_*lapU );
-            vNext_[id] = v_[id] + dt_*( -convV + nu_*lapV );
+    ScopedTimer timer("step");
+    Instrumentation::count(Counter::Steps);
+    auto t0 = telemetry_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    // Central differences on whole rows; the ghost layer carries the
+    // boundary condition
+    u_.fillGhosts(bc_);
+    v_.fillGhosts(bc_);
+    for(int j=0; j<Ny_; j++){
+        residualRow(u_, v_, j, nu_, dx_, dy_, Ru_.data(), Rv_.data());
+        const double* u = u_.row(j);
+        const double* v = v_.row(j);
+        double* uNext = uNext_.row(j);
+        double* vNext = vNext_.row(j);
+        for(int i=0; i<Nx_; i++){
+            uNext[i] = u[i] + dt_*Ru_[i];
+            vNext[i] = v[i] + dt_*Rv_[i];
         }
     }
 
-    // simple boundary: set to 0
-    for(int i=0; i<Nx_; i++){
-        uNext_[idx(i,0)] = 0.0; 
-        vNext_[idx(i,0)] = 0.0;
-        uNext_[idx(i,Ny_-1)] = 0.0;
-        vNext_[idx(i,Ny_-1)] = 0.0;
-    }
-    for(int j=0; j<Ny_; j++){
-        uNext_[idx(0,j)] = 0.0; 
-        vNext_[idx(0,j)] = 0.0;
-        uNext_[idx(Nx_-1,j)] = 0.0;
-        vNext_[idx(Nx_-1,j)] = 0.0;
-    }
+    // Dirichlet: boundary nodes back to 0
+    uNext_.applyBoundary(bc_);
+    vNext_.applyBoundary(bc_);
 
     // swap
-    std::swap(u_, uNext_);
-    std::swap(v_, vNext_);
+    u_.swap(uNext_);
+    v_.swap(vNext_);
+
+    time_ += dt_;
+    stepCount_++;
+    if (telemetry_ && stepCount_ % telemetryInterval_ == 0)
+        emitTelemetry(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
 }
 
-void OfflineSolver2D::storeSnapshot(double time) {
+void OfflineSolver2D::setTelemetry(TelemetryWriter* telemetry, int interval) {
+    telemetry_ = telemetry;
+    telemetryInterval_ = std::max(1, interval);
+}
+
+void OfflineSolver2D::emitTelemetry(double stepSeconds) {
+    double maxU = 0.0, maxV = 0.0, maxSpeed2 = 0.0, sum2 = 0.0;
+    for (int j = 0; j < Ny_; j++) {
+        const double* u = u_.row(j);
+        const double* v = v_.row(j);
+        for (int i = 0; i < Nx_; i++) {
+            double s2 = u[i]*u[i] + v[i]*v[i];
+            maxU = std::max(maxU, std::abs(u[i]));
+            maxV = std::max(maxV, std::abs(v[i]));
+            maxSpeed2 = std::max(maxSpeed2, s2);
+            sum2 += s2;
+        }
+    }
+    TelemetryRecord r{};
+    r.source = TelemetryWriter::kOffline;
+    r.step = stepCount_;
+    r.time = time_;
+    r.dt = dt_;
+    r.maxVelocity = std::sqrt(maxSpeed2);
+    r.cfl = dt_*(maxU/dx_ + maxV/dy_);
+    r.kineticEnergy = 0.5*sum2*dx_*dy_;
+    r.stepSeconds = stepSeconds;
+    telemetry_->push(r);
+}
+
+Eigen::VectorXd OfflineSolver2D::state() const {
     // Flatten [u, v] into an Eigen::VectorXd of length 2*Nx_*Ny_
     int n = 2*Nx_*Ny_;
     Eigen::VectorXd snap(n);
-    for(int j=0; j<Ny_; j++){
-        for(int i=0; i<Nx_; i++){
-            int id = idx(i,j);
-            snap(id) = u_[id];
-            snap(id + Nx_*Ny_) = v_[id];
-        }
+    u_.store(snap.data());
+    v_.store(snap.data() + Nx_*Ny_);
+    return snap;
+}
+
+void OfflineSolver2D::setState(const Eigen::VectorXd& x) {
+    if (x.size() != 2*Nx_*Ny_)
+        throw std::runtime_error("OfflineSolver2D::setState: wrong state size");
+    u_.load(x.data());
+    v_.load(x.data() + Nx_*Ny_);
+}
+
+void OfflineSolver2D::advance(int steps) {
+    for(int s=0; s<steps; s++){
+        stepExplicit();
     }
-    snapshots_.push_back(snap);
+}
+
+Eigen::VectorXd OfflineSolver2D::initialState() {
+    initialize();
+    return state();
+}
+
+void OfflineSolver2D::storeSnapshot(double time) {
+    snapshots_.push_back(state());
+    snapshotTimes_.push_back(time);
+}
+
+void OfflineSolver2D::clearSnapshots() {
+    snapshots_.clear();
+    snapshots_.shrink_to_fit();
+    snapshotTimes_.clear();
 }
 
 void OfflineSolver2D::writeSnapshotsToFile() {
@@ -151,12 +178,21 @@ void OfflineSolver2D::writeSnapshotsToFile() {
         }
         ofs << "\n";
     }
+    Instrumentation::count(Counter::BytesWritten, static_cast<std::int64_t>(ofs.tellp()));
     ofs.close();
     std::cout << "[OfflineSolver2D] Wrote " << m 
               << " snapshots to " << snapshotFile_ << std::endl;
 }
 
 void OfflineSolver2D::runOfflineSolve() {
+    simulate();
+    ScopedTimer timer("snapshotIO");
+    writeSnapshotsToFile();
+}
+
+void OfflineSolver2D::simulate() {
+    ScopedTimer timer("offline");
+    clearSnapshots();
     initialize();
     storeSnapshot(0.0);
 
@@ -169,6 +205,4 @@ void OfflineSolver2D::runOfflineSolve() {
     }
     // store final
     storeSnapshot(finalTime_);
-
-    writeSnapshotsToFile();
 }
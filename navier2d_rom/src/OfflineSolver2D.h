@@ -3,6 +3,8 @@
 #include <Eigen/Dense>
 #include <string>
 #include "Config.h"
+#include "Field2D.h"
+#include "Telemetry.h"
 
 // Offline solver for 2D Burgers: solves in full dimension
 // and writes snapshots to file.
@@ -13,6 +15,33 @@ public:
     // Run the PDE solve and write snapshots
     void runOfflineSolve();
 
+    // Run the PDE solve and keep snapshots in memory only
+    void simulate();
+
+    // Snapshots (each of length 2*Nx*Ny) and their times from the last solve
+    const std::vector<Eigen::VectorXd>& snapshots() const { return snapshots_; }
+    const std::vector<double>& snapshotTimes() const { return snapshotTimes_; }
+
+    // Drop stored snapshots to release memory
+    void clearSnapshots();
+
+    // Initial condition as a flattened [u, v] vector (cheap, no time stepping)
+    Eigen::VectorXd initialState();
+
+    // Current flattened [u, v] state
+    Eigen::VectorXd state() const;
+
+    // Overwrite the current state (length 2*Nx*Ny), e.g. a lifted ROM state
+    void setState(const Eigen::VectorXd& x);
+
+    // Advance the current state by the given number of explicit steps,
+    // without storing snapshots
+    void advance(int steps);
+
+    // Push a telemetry record every interval steps (nullptr detaches). The
+    // extra O(n) pass over the state only runs when a record is due.
+    void setTelemetry(TelemetryWriter* telemetry, int interval = 1);
+
 private:
     Config cfg_;
 
@@ -23,20 +52,28 @@ private:
     int snapshotInterval_;
     std::string snapshotFile_;
 
-    // Full-state storage: each cell has (u, v)
-    // We'll store them in 1D arrays of size Nx_*Ny_
-    std::vector<double> u_, v_;
+    BoundaryCondition bc_;
 
-    // Temporary arrays for next step
-    std::vector<double> uNext_, vNext_;
+    // Full-state storage: each node has (u, v), with a ghost layer
+    Field2D u_, v_;
+
+    // Temporary fields for next step, and one row of residual
+    Field2D uNext_, vNext_;
+    std::vector<double> Ru_, Rv_;
 
     // We'll keep snapshots in memory, then write at the end
     std::vector<Eigen::VectorXd> snapshots_;
+    std::vector<double> snapshotTimes_;
+
+    TelemetryWriter* telemetry_ = nullptr;
+    int telemetryInterval_ = 1;
+    std::int64_t stepCount_ = 0;
+    double time_ = 0.0;
 
     // Helpers
     void initialize();
     void stepExplicit();
     void storeSnapshot(double time);
     void writeSnapshotsToFile();
-    inline int idx(int i, int j) const { return i + j*Nx_; }
+    void emitTelemetry(double stepSeconds);
 };
@@ -1,36 +1,232 @@
 #include "OnlineSolver2D.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <fstream>
+#include <stdexcept>
 #include <iostream>
+#include "Instrumentation.h"
 #include "POD.h"
 
 OnlineSolver2D::OnlineSolver2D(const Config& cfg, GalerkinROM& rom)
-    : cfg_(cfg), rom_(rom)
+    : cfg_(cfg), dyn_(&rom), rom_(&rom)
 {
     dt_ = cfg_.dt;
     finalTime_ = cfg_.finalTime;
 }
 
-Eigen::VectorXd OnlineSolver2D::toReduced(const Eigen::VectorXd& x) {
+OnlineSolver2D::OnlineSolver2D(const Config& cfg, ReducedDynamics& dynamics)
+    : cfg_(cfg), dyn_(&dynamics), rom_(dynamic_cast<GalerkinROM*>(&dynamics))
+{
+    dt_ = cfg_.dt;
+    finalTime_ = cfg_.finalTime;
+}
+
+OnlineSolver2D::OnlineSolver2D(const Config& cfg, LocalGalerkinROM& local)
+    : cfg_(cfg), local_(&local)
+{
+    dt_ = cfg_.dt;
+    finalTime_ = cfg_.finalTime;
+}
+
+Eigen::VectorXd OnlineSolver2D::toReduced(const Eigen::Ref<const Eigen::VectorXd>& x) {
     // a = Phi^T x
-    const Eigen::MatrixXd& Phi = rom_.pod().basis(); // we'll adjust to get that
+    const Eigen::MatrixXd& Phi = dyn_->pod().basis(); // we'll adjust to get that
     return Phi.transpose() * x;
 }
 
 Eigen::VectorXd OnlineSolver2D::toFull(const Eigen::VectorXd& a) {
-    const Eigen::MatrixXd& Phi = rom_.pod().basis();
+    const Eigen::MatrixXd& Phi = dyn_->pod().basis();
     return Phi * a;
 }
 
-Eigen::VectorXd OnlineSolver2D::runReducedSolve(const Eigen::VectorXd& initialFull) {
+Eigen::VectorXd OnlineSolver2D::runReducedSolve(const Eigen::Ref<const Eigen::VectorXd>& initialFull) {
+    ScopedTimer timer("online");
+    if (local_)
+        return runLocalSolve(initialFull);
+
     // 1) convert to reduced
     Eigen::VectorXd a = toReduced(initialFull);
 
     int steps = static_cast<int>(std::ceil(finalTime_/dt_));
+    errorHistory_.clear();
+    clearOutputs();
+    const bool indicator = rom_ && rom_->hasErrorIndicator();
+    if (indicator)
+        errorHistory_.reserve(steps);
+    double accumulated = 0.0;
     for(int s=0; s<steps; s++){
-        a = rom_.stepExplicitEuler(a, dt_);
+        recordOutputs(s*dt_, a);
+        if (stateInterval_ > 0 && s % stateInterval_ == 0) {
+            stateHistory_.push_back(a);
+            stateTimes_.push_back(s*dt_);
+        }
+        auto t0 = telemetry_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+        if (indicator) {
+            // Same Euler step, keeping the RHS for the O(k^4) indicator
+            Eigen::VectorXd rhs = rom_->computeReducedRHS(a);
+            double fullNorm = 0.0;
+            double res = rom_->residualIndicator(a, rhs, &fullNorm);
+            accumulated += dt_*res;
+            errorHistory_.push_back({s*dt_, res, res/(fullNorm + 1e-300), accumulated});
+            a += dt_*rhs;
+        } else {
+            a = dyn_->stepExplicitEuler(a, dt_);
+        }
+        if (telemetry_ && (s+1) % telemetryInterval_ == 0)
+            emitTelemetry(s+1, a, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+    Instrumentation::count(Counter::Steps, steps);
+    recordOutputs(steps*dt_, a);
+    if (stateInterval_ > 0) {
+        if (steps % stateInterval_ == 0) {
+            stateHistory_.push_back(a);
+            stateTimes_.push_back(steps*dt_);
+        }
+        stateHistory_.push_back(a);
+        stateTimes_.push_back(finalTime_);
     }
 
     // 2) reconstruct final
     Eigen::VectorXd finalFull = toFull(a);
     return finalFull;
 }
+
+Eigen::VectorXd OnlineSolver2D::runLocalSolve(const Eigen::Ref<const Eigen::VectorXd>& initialFull) {
+    // Start in the basis of the cluster nearest to the initial state
+    int c = local_->nearestCluster(initialFull);
+    Eigen::VectorXd a = local_->basis(c).transpose() * initialFull;
+    basisSwitches_ = 0;
+
+    int steps = static_cast<int>(std::ceil(finalTime_/dt_));
+    for(int s=0; s<steps; s++){
+        a = local_->rom(c).stepExplicitEuler(a, dt_);
+
+        // O(k K) membership test in reduced coordinates
+        int next = local_->nearestCluster(c, a);
+        if (next != c) {
+            a = local_->transition(c, next, a);
+            c = next;
+            basisSwitches_++;
+        }
+    }
+    Instrumentation::count(Counter::Steps, steps);
+
+    return local_->basis(c) * a;
+}
+
+void OnlineSolver2D::writeErrorHistory(const std::string& file) const {
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs << "time,residual,relative,accumulated\n";
+    for (const auto& r : errorHistory_)
+        ofs << r.time << "," << r.residual << "," << r.relative << "," << r.accumulated << "\n";
+}
+
+void OnlineSolver2D::setProbes(const std::vector<Eigen::Vector2d>& points) {
+    if (!dyn_)
+        throw std::runtime_error("Probes need a global reduced model");
+    double dx = cfg_.dx();
+    double dy = cfg_.dy();
+    probes_ = std::make_unique<OutputProbes>(dyn_->pod().basis(), cfg_.Nx, cfg_.Ny,
+                                             dx, dy, points, boundaryFromString(cfg_.boundary));
+}
+
+void OnlineSolver2D::clearOutputs() {
+    stateHistory_.clear();
+    stateTimes_.clear();
+    outputTimes_.clear();
+    probeHistory_.clear();
+    functionalHistory_.clear();
+}
+
+// Per-step monitoring; everything here works on reduced coordinates only.
+void OnlineSolver2D::recordOutputs(double time, const Eigen::VectorXd& a) {
+    if (!probes_ && !functionals_)
+        return;
+    outputTimes_.push_back(time);
+    if (probes_)
+        probeHistory_.push_back(probes_->evaluate(a));
+    if (functionals_)
+        functionalHistory_.push_back(functionals_->evaluate(a));
+}
+
+void OnlineSolver2D::setTelemetry(TelemetryWriter* telemetry, int interval) {
+    telemetry_ = telemetry;
+    telemetryInterval_ = std::max(1, interval);
+    if (!telemetry_)
+        return;
+    if (!dyn_)
+        throw std::runtime_error("Telemetry needs a global reduced model");
+    const Eigen::MatrixXd& Phi = dyn_->pod().basis();
+    const Eigen::Index half = Phi.rows() / 2;
+    modeMaxU_ = Phi.topRows(half).cwiseAbs().colwise().maxCoeff().transpose();
+    modeMaxV_ = Phi.bottomRows(half).cwiseAbs().colwise().maxCoeff().transpose();
+}
+
+void OnlineSolver2D::emitTelemetry(int step, const Eigen::VectorXd& a, double stepSeconds) {
+    double dx = cfg_.dx();
+    double dy = cfg_.dy();
+    double maxU = modeMaxU_.dot(a.cwiseAbs());
+    double maxV = modeMaxV_.dot(a.cwiseAbs());
+    TelemetryRecord r{};
+    r.source = TelemetryWriter::kOnline;
+    r.step = step;
+    r.time = step*dt_;
+    r.dt = dt_;
+    r.maxVelocity = std::sqrt(maxU*maxU + maxV*maxV);
+    r.cfl = dt_*(maxU/dx + maxV/dy);
+    r.kineticEnergy = 0.5*a.squaredNorm()*dx*dy;
+    r.stepSeconds = stepSeconds;
+    telemetry_->push(r);
+}
+
+ReducedFunctionals& OnlineSolver2D::enableFunctionals() {
+    if (!dyn_)
+        throw std::runtime_error("Functionals need a global reduced model");
+    double dx = cfg_.dx();
+    double dy = cfg_.dy();
+    functionals_ = std::make_unique<ReducedFunctionals>(dyn_->pod().basis(), cfg_.Nx, cfg_.Ny,
+                                                        dx, dy, boundaryFromString(cfg_.boundary));
+    return *functionals_;
+}
+
+void OnlineSolver2D::writeFunctionalHistory(const std::string& file) const {
+    if (!functionals_)
+        throw std::runtime_error("No functionals enabled");
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs << "time";
+    for (const auto& name : functionals_->names())
+        ofs << "," << name;
+    ofs << "\n";
+    for (std::size_t s = 0; s < functionalHistory_.size(); s++) {
+        ofs << outputTimes_[s];
+        for (Eigen::Index i = 0; i < functionalHistory_[s].size(); i++)
+            ofs << "," << functionalHistory_[s](i);
+        ofs << "\n";
+    }
+}
+
+void OnlineSolver2D::writeProbeHistory(const std::string& file) const {
+    if (!probes_)
+        throw std::runtime_error("No probes set");
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    const int p = probes_->numPoints();
+    ofs << "time";
+    for (int q = 0; q < p; q++)
+        ofs << ",u" << q;
+    for (int q = 0; q < p; q++)
+        ofs << ",v" << q;
+    ofs << "\n";
+    for (std::size_t s = 0; s < probeHistory_.size(); s++) {
+        ofs << outputTimes_[s];
+        for (Eigen::Index q = 0; q < probeHistory_[s].size(); q++)
+            ofs << "," << probeHistory_[s](q);
+        ofs << "\n";
+    }
+}
@@ -1,26 +1,112 @@
 #pragma once
 #include <Eigen/Dense>
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <string>
 #include "Config.h"
 #include "GalerkinROM.h"
+#include "LocalGalerkinROM.h"
+#include "OutputProbes.h"
+#include "ReducedFunctionals.h"
+#include "Telemetry.h"
+
+// Per-step output of the reduced-space error indicator
+struct ErrorIndicatorRecord
+{
+    double time;
+    double residual;     // ||(I - Phi Phi^T) R(Phi a)||
+    double relative;     // residual / ||R(Phi a)||
+    double accumulated;  // time integral of residual up to this step
+};
 
 class OnlineSolver2D {
 public:
     OnlineSolver2D(const Config& cfg, GalerkinROM& rom);
 
+    // Any other reduced model (e.g. operator inference); the Galerkin-only
+    // error indicator is then unavailable
+    OnlineSolver2D(const Config& cfg, ReducedDynamics& dynamics);
+
+    // Localized ROM: the solve switches between the cluster bases of local
+    OnlineSolver2D(const Config& cfg, LocalGalerkinROM& local);
+
     // Run the reduced solve from an initial condition a0
     // returns final solution in FULL space for comparison
-    Eigen::VectorXd runReducedSolve(const Eigen::VectorXd& initialFull);
+    // (a column of a snapshot matrix or a mapped buffer is not copied)
+    Eigen::VectorXd runReducedSolve(const Eigen::Ref<const Eigen::VectorXd>& initialFull);
+
+    // Basis switches made by the last localized solve
+    int basisSwitches() const { return basisSwitches_; }
+
+    // Error indicator at every step of the last solve; filled only when the
+    // Galerkin ROM was assembled with its error indicator.
+    const std::vector<ErrorIndicatorRecord>& errorHistory() const { return errorHistory_; }
+    void writeErrorHistory(const std::string& file) const;
+
+    // Output probes (global ROM only): u, v at the given (x, y) points are
+    // recorded after every step from reduced coordinates, O(p k) per step.
+    void setProbes(const std::vector<Eigen::Vector2d>& points);
+    const OutputProbes* probes() const { return probes_.get(); }
+    // One entry per recorded time: [u(p_0..), v(p_0..)]
+    const std::vector<Eigen::VectorXd>& probeHistory() const { return probeHistory_; }
+    const std::vector<double>& outputTimes() const { return outputTimes_; }
+    void writeProbeHistory(const std::string& file) const;
+
+    // Reduced output functionals (global ROM only): energy, enstrophy, mean
+    // vorticity and midline flux, plus any added through the returned
+    // object, recorded at the same times as the probes at O(k^2) per step.
+    ReducedFunctionals& enableFunctionals();
+    const ReducedFunctionals* functionals() const { return functionals_.get(); }
+    const std::vector<Eigen::VectorXd>& functionalHistory() const { return functionalHistory_; }
+    void writeFunctionalHistory(const std::string& file) const;
+
+    // Reduced states of the global solve at the times OfflineSolver2D
+    // stores snapshots for the same snapshotInterval: every interval steps
+    // from t = 0, then finalTime (interval 0 disables). Columns of A for
+    // validateTrajectory.
+    void recordReducedStates(int interval) { stateInterval_ = std::max(0, interval); }
+    const std::vector<Eigen::VectorXd>& reducedHistory() const { return stateHistory_; }
+    const std::vector<double>& reducedTimes() const { return stateTimes_; }
+
+    // Push a telemetry record every interval steps of the global solve
+    // (nullptr detaches). Everything is computed from a in O(k): the
+    // energy as 0.5 dx dy |a|^2 (orthonormal basis), and max |u|, max |v|
+    // bounded by sum |a_i| max |phi_i|, so maxVelocity and cfl are upper
+    // bounds.
+    void setTelemetry(TelemetryWriter* telemetry, int interval = 1);
 
 private:
     Config cfg_;
-    GalerkinROM& rom_;
+    ReducedDynamics* dyn_ = nullptr;  // the global model
+    GalerkinROM* rom_ = nullptr;      // same object, if it is a GalerkinROM
+    LocalGalerkinROM* local_ = nullptr;
+    int basisSwitches_ = 0;
+    std::vector<ErrorIndicatorRecord> errorHistory_;
+
+    std::unique_ptr<OutputProbes> probes_;
+    std::vector<double> outputTimes_;
+    std::vector<Eigen::VectorXd> probeHistory_;
+    std::unique_ptr<ReducedFunctionals> functionals_;
+    std::vector<Eigen::VectorXd> functionalHistory_;
+    int stateInterval_ = 0;
+    std::vector<Eigen::VectorXd> stateHistory_;
+    std::vector<double> stateTimes_;
+
+    TelemetryWriter* telemetry_ = nullptr;
+    int telemetryInterval_ = 1;
+    Eigen::VectorXd modeMaxU_, modeMaxV_;  // max |phi_i| over the u / v rows
 
     double dt_, finalTime_;
 
     // Convert from full initial vector to reduced coords: a0 = Phi^T * x0
-    Eigen::VectorXd toReduced(const Eigen::VectorXd& x);
+    Eigen::VectorXd toReduced(const Eigen::Ref<const Eigen::VectorXd>& x);
     // Reconstruct from a => x
     Eigen::VectorXd toFull(const Eigen::VectorXd& a);
+
+    Eigen::VectorXd runLocalSolve(const Eigen::Ref<const Eigen::VectorXd>& initialFull);
+
+    void clearOutputs();
+    void recordOutputs(double time, const Eigen::VectorXd& a);
+    void emitTelemetry(int step, const Eigen::VectorXd& a, double stepSeconds);
 };
@@ -0,0 +1,255 @@
+#include "OperatorInferenceROM.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include "Instrumentation.h"
+#include "OnlineSolver2D.h"
+
+static const char kMagic[8] = {'N', '2', 'D', 'O', 'P', 'I', '0', '1'};
+
+OperatorInferenceROM::OperatorInferenceROM(const Config& cfg)
+    : cfg_(cfg),
+      pod_(cfg.numPodModes,
+           POD::methodFromString(cfg.podMethod == "tsqr" ? "auto" : cfg.podMethod))
+{
+    pod_.setRandomizedOptions(cfg.podOversampling, cfg.podPowerIterations, cfg.podSeed);
+    pod_.setEnergyThreshold(cfg.podEnergy);
+}
+
+// Times of the columns OfflineSolver2D::simulate stores
+std::vector<double> OperatorInferenceROM::snapshotTimes(int count) const {
+    const int steps = static_cast<int>(std::ceil(cfg_.finalTime/cfg_.dt));
+    std::vector<double> times;
+    for (int s = 0; s <= steps; s += cfg_.snapshotInterval)
+        times.push_back(s*cfg_.dt);
+    times.push_back(cfg_.finalTime);
+    if (static_cast<int>(times.size()) != count)
+        throw std::runtime_error("OperatorInferenceROM: snapshot count does not match the "
+                                 "config's schedule; pass the snapshot times");
+    return times;
+}
+
+void OperatorInferenceROM::train(const Eigen::MatrixXd& X) {
+    train(X, snapshotTimes(X.cols()));
+}
+
+void OperatorInferenceROM::train(const Eigen::MatrixXd& X, const std::vector<double>& times) {
+    if (static_cast<Eigen::Index>(times.size()) != X.cols())
+        throw std::runtime_error("OperatorInferenceROM: one time per snapshot required");
+    pod_.computeBasis(X);
+    fit(pod_.basis().transpose() * X, times);
+}
+
+void OperatorInferenceROM::train(const POD& pod, const Eigen::MatrixXd& X) {
+    pod_ = pod;
+    fit(pod_.basis().transpose() * X, snapshotTimes(X.cols()));
+}
+
+Eigen::VectorXd OperatorInferenceROM::quadraticTerms(const Eigen::VectorXd& a) {
+    const int k = a.size();
+    Eigen::VectorXd q(k*(k+1)/2);
+    int p = 0;
+    for (int i = 0; i < k; i++)
+        for (int j = i; j < k; j++)
+            q(p++) = a(i)*a(j);
+    return q;
+}
+
+// Column-wise quadratic terms of a batch (k(k+1)/2 x B)
+Eigen::MatrixXd OperatorInferenceROM::quadraticTerms(const Eigen::MatrixXd& A) {
+    Eigen::MatrixXd Q;
+    quadraticTerms(A, Q);
+    return Q;
+}
+
+// Same into Q, resized only when the batch shape changes
+void OperatorInferenceROM::quadraticTerms(const Eigen::Ref<const Eigen::MatrixXd>& A, Eigen::MatrixXd& Q) {
+    const int k = A.rows();
+    Q.resize(k*(k+1)/2, A.cols());
+    int p = 0;
+    for (int i = 0; i < k; i++)
+        for (int j = i; j < k; j++)
+            Q.row(p++) = A.row(i).cwiseProduct(A.row(j));
+}
+
+void OperatorInferenceROM::fit(const Eigen::MatrixXd& Ared, const std::vector<double>& times) {
+    ScopedTimer timer("opinfFit");
+    const int k = Ared.rows();
+    const int nq = k*(k+1)/2;
+
+    // Drop repeated times (the final snapshot can coincide with the last
+    // regular one)
+    std::vector<int> cols;
+    for (int j = 0; j < Ared.cols(); j++) {
+        if (!cols.empty() && times[j] <= times[cols.back()] + 1e-14)
+            continue;
+        cols.push_back(j);
+    }
+    const int m = static_cast<int>(cols.size()) - 2;  // interior points only
+    if (m < 1)
+        throw std::runtime_error("OperatorInferenceROM: need at least 3 distinct snapshot times");
+
+    // Data and second-order central differences on the (possibly uneven)
+    // time grid
+    Eigen::MatrixXd D(m, k + nq), R(m, k);
+    for (int r = 0; r < m; r++) {
+        int j0 = cols[r], j1 = cols[r+1], j2 = cols[r+2];
+        double h1 = times[j1] - times[j0];
+        double h2 = times[j2] - times[j1];
+        Eigen::VectorXd a = Ared.col(j1);
+        Eigen::VectorXd dadt = -h2/(h1*(h1+h2)) * Ared.col(j0)
+                             + (h2-h1)/(h1*h2)  * a
+                             + h1/(h2*(h1+h2))  * Ared.col(j2);
+        D.row(r).head(k) = a.transpose();
+        D.row(r).tail(nq) = quadraticTerms(a).transpose();
+        R.row(r) = dadt.transpose();
+    }
+
+    // Regularized least squares via the stacked system [D; sqrt(lambda) I]
+    auto solve = [&](double lambda) {
+        Eigen::MatrixXd Dreg = Eigen::MatrixXd::Zero(m + k + nq, k + nq);
+        Eigen::MatrixXd Rreg = Eigen::MatrixXd::Zero(m + k + nq, k);
+        Dreg.topRows(m) = D;
+        Dreg.bottomRows(k + nq).diagonal().setConstant(std::sqrt(lambda));
+        Rreg.topRows(m) = R;
+        Eigen::MatrixXd O = Dreg.colPivHouseholderQr().solve(Rreg);
+        A_ = O.topRows(k).transpose();
+        H_ = O.bottomRows(nq).transpose();
+        fitResidual_ = (D*O - R).norm() / (R.norm() + 1e-300);
+    };
+
+    double lambda = cfg_.opinfRegularization;
+    if (lambda > 0.0) {
+        solve(lambda);
+    } else {
+        // A small residual does not make a stable model: pick lambda on a
+        // log grid by the error of the integrated model over the training
+        // window instead
+        double bestError = std::numeric_limits<double>::infinity();
+        lambda = 1.0;
+        for (int e = -10; e <= 4; e++) {
+            solve(std::pow(10.0, e));
+            double err = trajectoryError(Ared, times, cols);
+            if (err < bestError) {
+                bestError = err;
+                lambda = std::pow(10.0, e);
+            }
+        }
+        solve(lambda);
+        std::cout << "[OperatorInferenceROM] Selected lambda " << lambda
+                  << " (training trajectory error " << bestError << ")\n";
+    }
+
+    std::cout << "[OperatorInferenceROM] Fitted " << k << "-mode linear + quadratic operators on "
+              << m << " samples (lambda " << lambda << "), relative residual "
+              << fitResidual_ << "\n";
+}
+
+// Relative error of the model's explicit Euler trajectory from the first
+// sample against the reduced snapshots at cols; infinite if it blows up
+double OperatorInferenceROM::trajectoryError(const Eigen::MatrixXd& Ared,
+                                             const std::vector<double>& times,
+                                             const std::vector<int>& cols) {
+    Eigen::VectorXd a = Ared.col(cols.front());
+    double t = times[cols.front()];
+    double err2 = 0.0, ref2 = 0.0;
+    for (std::size_t c = 1; c < cols.size(); c++) {
+        const Eigen::VectorXd target = Ared.col(cols[c]);
+        while (t < times[cols[c]] - 1e-12) {
+            double h = std::min(cfg_.dt, times[cols[c]] - t);
+            a += h*computeReducedRHS(a);
+            t += h;
+        }
+        if (!a.allFinite() || a.norm() > 1e3*(target.norm() + 1.0))
+            return std::numeric_limits<double>::infinity();
+        err2 += (a - target).squaredNorm();
+        ref2 += target.squaredNorm();
+    }
+    return std::sqrt(err2 / (ref2 + 1e-300));
+}
+
+Eigen::VectorXd OperatorInferenceROM::computeReducedRHS(const Eigen::VectorXd& a) {
+    return A_*a + H_*quadraticTerms(a);
+}
+
+Eigen::MatrixXd OperatorInferenceROM::computeReducedRHSBatch(const Eigen::MatrixXd& A) {
+    Eigen::MatrixXd R, work;
+    computeReducedRHSBatch(A, R, work);
+    return R;
+}
+
+void OperatorInferenceROM::computeReducedRHSBatch(const Eigen::Ref<const Eigen::MatrixXd>& A,
+                                                  Eigen::MatrixXd& R, Eigen::MatrixXd& work) {
+    quadraticTerms(A, work);
+    R.noalias() = A_*A;
+    R.noalias() += H_*work;
+}
+
+Eigen::VectorXd OperatorInferenceROM::predict(const Eigen::VectorXd& initialState) {
+    OnlineSolver2D online(cfg_, *this);
+    return online.runReducedSolve(initialState);
+}
+
+void OperatorInferenceROM::predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X0,
+                                        Eigen::Ref<Eigen::MatrixXd> out) {
+    ScopedTimer timer("online");
+    if (out.rows() != X0.rows() || out.cols() != X0.cols())
+        throw std::runtime_error("predictBatch: output must match the input size");
+    if (X0.rows() != pod_.basis().rows())
+        throw std::runtime_error("predictBatch: input does not match the basis size");
+    const Eigen::MatrixXd& Phi = pod_.basis();
+    Eigen::MatrixXd A = Phi.transpose() * X0;
+    const int steps = static_cast<int>(std::ceil(cfg_.finalTime/cfg_.dt));
+    integrateBatch(A, cfg_.dt, steps);
+    Instrumentation::count(Counter::Steps, static_cast<std::int64_t>(steps)*X0.cols());
+    out.noalias() = Phi * A;
+}
+
+void OperatorInferenceROM::saveResults(const std::string& filename) {
+    saveOperators(filename);
+}
+
+void OperatorInferenceROM::saveOperators(const std::string& file) const {
+    std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs.write(kMagic, 8);
+    std::int64_t k = A_.rows();
+    ofs.write(reinterpret_cast<const char*>(&k), sizeof(k));
+    ofs.write(reinterpret_cast<const char*>(A_.data()), A_.size()*sizeof(double));
+    ofs.write(reinterpret_cast<const char*>(H_.data()), H_.size()*sizeof(double));
+    if (!ofs)
+        throw std::runtime_error("Error writing " + file);
+    Instrumentation::count(Counter::BytesWritten, static_cast<std::int64_t>(ofs.tellp()));
+}
+
+void OperatorInferenceROM::save(const std::string& basisFile, const std::string& operatorFile) const {
+    pod_.saveBasis(basisFile);
+    saveOperators(operatorFile);
+}
+
+void OperatorInferenceROM::load(const std::string& basisFile, const std::string& operatorFile) {
+    pod_.loadBasis(basisFile);
+    std::ifstream ifs(operatorFile, std::ios::binary);
+    if (!ifs.is_open())
+        throw std::runtime_error("Cannot open " + operatorFile);
+    char magic[8] = {};
+    std::int64_t k = 0;
+    ifs.read(magic, 8);
+    if (!ifs || std::string(magic, 8) != std::string(kMagic, 8))
+        throw std::runtime_error(operatorFile + " is not an operator-inference model");
+    ifs.read(reinterpret_cast<char*>(&k), sizeof(k));
+    if (!ifs || k != pod_.basis().cols())
+        throw std::runtime_error("Operator file " + operatorFile + " does not match the basis");
+    A_.resize(k, k);
+    H_.resize(k, k*(k+1)/2);
+    ifs.read(reinterpret_cast<char*>(A_.data()), A_.size()*sizeof(double));
+    ifs.read(reinterpret_cast<char*>(H_.data()), H_.size()*sizeof(double));
+    if (!ifs)
+        throw std::runtime_error("Truncated operator file " + operatorFile);
+    Instrumentation::count(Counter::BytesRead, static_cast<std::int64_t>(ifs.tellg()));
+}
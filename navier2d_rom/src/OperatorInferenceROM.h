@@ -0,0 +1,82 @@
+#pragma once
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+#include "Config.h"
+#include "POD.h"
+#include "ReducedDynamics.h"
+#include "ReducedOrderModel.h"
+
+// Non-intrusive reduced model learned by operator inference: with
+// a_j = Phi^T x(t_j) and finite-difference derivatives da/dt(t_j), fit
+//
+//     da/dt = A a + H q(a),   q(a) = [a_i a_j], i <= j   (k(k+1)/2 terms)
+//
+// by Tikhonov-regularized least squares,
+//
+//     min ||D O - R||^2 + lambda ||O||^2,   D = [a_j^T  q(a_j)^T],  O = [A H]^T.
+//
+// Only snapshots are needed, never the solver's residual. Online
+// evaluation is O(k^3) like the assembled Galerkin operators. The
+// derivatives are second-order central differences in time, so training
+// data should be sampled finely (a small snapshotInterval). A small fit
+// residual does not guarantee a stable model, so by default lambda is
+// chosen on a log grid by the error of the integrated model over the
+// training window.
+class OperatorInferenceROM : public ReducedOrderModel, public ReducedDynamics {
+public:
+    // Uses numPodModes, podMethod, podEnergy, dt, finalTime, snapshotInterval
+    // and opinfRegularization (lambda; <= 0 selects it automatically) from cfg
+    explicit OperatorInferenceROM(const Config& cfg);
+
+    // POD of X, then the operator fit. Snapshot times are those written by
+    // OfflineSolver2D: every snapshotInterval steps, plus finalTime.
+    void train(const Eigen::MatrixXd& X) override;
+    // Same with explicit snapshot times (increasing; repeated times are
+    // dropped)
+    void train(const Eigen::MatrixXd& X, const std::vector<double>& times);
+    // Operator fit only, reusing a basis already computed from X
+    void train(const POD& pod, const Eigen::MatrixXd& X) override;
+
+    // Integrate from Phi^T x0 to finalTime with OnlineSolver2D; full state
+    Eigen::VectorXd predict(const Eigen::VectorXd& initialState) override;
+    // Whole batch as one k x B block: projection, steps and reconstruction
+    // are GEMMs
+    void predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X0,
+                      Eigen::Ref<Eigen::MatrixXd> out) override;
+
+    // Writes the learned operators (see saveOperators)
+    void saveResults(const std::string& filename) override;
+
+    const POD& pod() const override { return pod_; }
+    Eigen::VectorXd computeReducedRHS(const Eigen::VectorXd& a) override;
+    Eigen::MatrixXd computeReducedRHSBatch(const Eigen::MatrixXd& A) override;
+    // In place; work holds the k(k+1)/2 x B quadratic terms between calls
+    void computeReducedRHSBatch(const Eigen::Ref<const Eigen::MatrixXd>& A, Eigen::MatrixXd& R,
+                                Eigen::MatrixXd& work) override;
+
+    const Eigen::MatrixXd& linearOperator() const { return A_; }     // k x k
+    const Eigen::MatrixXd& quadraticOperator() const { return H_; }  // k x k(k+1)/2
+    // ||D O - R|| / ||R|| of the last fit
+    double fitResidual() const { return fitResidual_; }
+
+    // Operator I/O (binary: magic "N2DOPI01", int64 k, then A and H
+    // column-major); save/load also write and read the basis.
+    void saveOperators(const std::string& file) const;
+    void save(const std::string& basisFile, const std::string& operatorFile) const override;
+    void load(const std::string& basisFile, const std::string& operatorFile) override;
+
+private:
+    Config cfg_;
+    POD pod_;
+    Eigen::MatrixXd A_, H_;
+    double fitResidual_ = 0.0;
+
+    void fit(const Eigen::MatrixXd& Ared, const std::vector<double>& times);
+    double trajectoryError(const Eigen::MatrixXd& Ared, const std::vector<double>& times,
+                           const std::vector<int>& cols);
+    std::vector<double> snapshotTimes(int count) const;
+    static Eigen::VectorXd quadraticTerms(const Eigen::VectorXd& a);
+    static Eigen::MatrixXd quadraticTerms(const Eigen::MatrixXd& A);
+    static void quadraticTerms(const Eigen::Ref<const Eigen::MatrixXd>& A, Eigen::MatrixXd& Q);
+};
@@ -0,0 +1,64 @@
+#include "OutputProbes.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+OutputProbes::OutputProbes(const Eigen::MatrixXd& basis, int Nx, int Ny, double dx, double dy,
+                           const std::vector<Eigen::Vector2d>& points, BoundaryCondition bc)
+    : points_(points)
+{
+    const int p = points_.size();
+    const int off = Nx*Ny;
+    const bool periodic = bc == BoundaryCondition::Periodic;
+    // Periodic grids have one more cell, wrapping back to node 0
+    const int cellsX = periodic ? Nx : Nx - 1;
+    const int cellsY = periodic ? Ny : Ny - 1;
+    rows_ = Eigen::MatrixXd::Zero(2*p, basis.cols());
+
+    for (int q = 0; q < p; q++) {
+        double gx = points_[q].x() / dx;
+        double gy = points_[q].y() / dy;
+        const double eps = 1e-9;
+        if (gx < -eps || gy < -eps || gx > cellsX + eps || gy > cellsY + eps) {
+            std::ostringstream oss;
+            oss << "Probe point (" << points_[q].x() << ", " << points_[q].y()
+                << ") is outside the domain";
+            throw std::runtime_error(oss.str());
+        }
+        // Lower-left node of the containing cell and the local coordinates
+        int i0 = std::clamp(static_cast<int>(std::floor(gx)), 0, cellsX - 1);
+        int j0 = std::clamp(static_cast<int>(std::floor(gy)), 0, cellsY - 1);
+        double fx = std::clamp(gx - i0, 0.0, 1.0);
+        double fy = std::clamp(gy - j0, 0.0, 1.0);
+        int i1 = (i0 + 1) % Nx;
+        int j1 = (j0 + 1) % Ny;
+
+        const int corner[4] = {i0 + j0*Nx, i1 + j0*Nx, i0 + j1*Nx, i1 + j1*Nx};
+        const double w[4] = {(1-fx)*(1-fy), fx*(1-fy), (1-fx)*fy, fx*fy};
+        for (int c = 0; c < 4; c++) {
+            rows_.row(q)     += w[c] * basis.row(corner[c]);
+            rows_.row(p + q) += w[c] * basis.row(corner[c] + off);
+        }
+    }
+}
+
+std::vector<Eigen::Vector2d> OutputProbes::readPoints(const std::string& file) {
+    std::ifstream ifs(file);
+    if (!ifs.is_open())
+        throw std::runtime_error("Cannot open probe file: " + file);
+
+    std::vector<Eigen::Vector2d> points;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        auto pos = line.find('#');
+        if (pos != std::string::npos)
+            line = line.substr(0, pos);
+        std::istringstream iss(line);
+        double x, y;
+        if (iss >> x >> y)
+            points.emplace_back(x, y);
+    }
+    return points;
+}
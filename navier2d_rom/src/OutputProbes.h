@@ -0,0 +1,36 @@
+#pragma once
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+#include "Field2D.h"
+
+// Sparse output probes: u and v at a set of (x, y) points, bilinearly
+// interpolated from the grid. The corresponding interpolated rows of the
+// basis are extracted once, so evaluating all probes from reduced
+// coordinates costs O(p k) instead of reconstructing all 2*Nx*Ny values.
+class OutputProbes {
+public:
+    // Grid node (i, j) sits at (i*dx, j*dy); the basis stores [u, v] with
+    // index i + j*Nx (u) and i + j*Nx + Nx*Ny (v). Points must lie inside
+    // [0, (Nx-1)dx] x [0, (Ny-1)dy], or [0, Nx dx] x [0, Ny dy] when periodic,
+    // where the last cell interpolates between node Nx-1 and node 0.
+    OutputProbes(const Eigen::MatrixXd& basis, int Nx, int Ny, double dx, double dy,
+                 const std::vector<Eigen::Vector2d>& points,
+                 BoundaryCondition bc = BoundaryCondition::Dirichlet);
+
+    int numPoints() const { return static_cast<int>(points_.size()); }
+    const std::vector<Eigen::Vector2d>& points() const { return points_; }
+
+    // [u(p_0..p_{p-1}), v(p_0..p_{p-1})] for the state Phi a
+    Eigen::VectorXd evaluate(const Eigen::VectorXd& a) const { return rows_ * a; }
+
+    // Interpolated basis rows (2p x k)
+    const Eigen::MatrixXd& rows() const { return rows_; }
+
+    // Read "x y" pairs, one per line ('#' starts a comment)
+    static std::vector<Eigen::Vector2d> readPoints(const std::string& file);
+
+private:
+    std::vector<Eigen::Vector2d> points_;
+    Eigen::MatrixXd rows_;
+};
@@ -1,19 +1,304 @@
 #include "POD.h"
+#include <Eigen/Eigenvalues>
+#include <Eigen/QR>
 #include <Eigen/SVD>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <random>
+#include <stdexcept>
+#include "Instrumentation.h"
+#include "ParallelLinAlg.h"
+#include "SnapshotIO.h"
+#include "TSQR.h"
 
-POD::POD(int numModes)
-    : k_(numModes)
+POD::POD(int numModes, Method method)
+    : k_(numModes), method_(method), lastMethod_(method)
 {}
 
-void POD::computeBasis(const Eigen::MatrixXd& X) {
+void POD::setEnergyThreshold(double fraction) {
+    energyThreshold_ = fraction;
+}
+
+double POD::capturedEnergy(int k) const {
+    if (totalEnergy_ <= 0.0)
+        return 1.0;
+    k = std::min<int>(k, singularValues_.size());
+    return std::min(1.0, singularValues_.head(k).squaredNorm() / totalEnergy_);
+}
+
+// Fixed k_ modes, or with an energy threshold the smallest k that captures
+// it; never more than the available left singular vectors.
+int POD::chooseRank(int available) const {
+    if (energyThreshold_ <= 0.0)
+        return available;
+    int k = 1;
+    while (k < available && capturedEnergy(k) < energyThreshold_)
+        k++;
+    return std::min(k, available);
+}
+
+void POD::printTruncationReport(std::ostream& os,
+                                const std::function<double(int)>& flopsPerStep,
+                                int maxRows) const
+{
+    int rows = std::min<int>(singularValues_.size(), maxRows);
+    int chosen = numModes();
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << "[POD] Truncation report (chosen k=" << chosen << ")\n";
+    os << "     k   sigma_k        captured energy   flops/step\n";
+    for (int k = 1; k <= rows; k++) {
+        os << (k == chosen ? "  -> " : "     ")
+           << std::left << std::setw(4) << k
+           << std::scientific << std::setprecision(4)
+           << std::setw(15) << singularValues_(k-1)
+           << std::fixed << std::setprecision(8)
+           << std::setw(18) << capturedEnergy(k)
+           << std::scientific << std::setprecision(3)
+           << flopsPerStep(k) << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void POD::setRandomizedOptions(int oversampling, int powerIterations, unsigned seed) {
+    oversampling_ = std::max(0, oversampling);
+    powerIterations_ = std::max(0, powerIterations);
+    seed_ = seed;
+}
+
+POD::Method POD::resolveMethod(Eigen::Index n, Eigen::Index m) {
+    // Tall-skinny (the usual case: many grid values, few snapshots): the
+    // m x m Gram matrix is cheap to form in parallel and to diagonalize.
+    if (n >= 8*m)
+        return Method::Snapshots;
+    // Moderately tall: reduce to an m x m problem with QR, which keeps the
+    // conditioning of X instead of squaring it.
+    if (n >= 2*m)
+        return Method::QR;
+    return Method::BDC;
+}
+
+POD::Method POD::methodFromString(const std::string& name) {
+    if (name == "auto")      return Method::Auto;
+    if (name == "jacobi")    return Method::Jacobi;
+    if (name == "bdc")       return Method::BDC;
+    if (name == "snapshots") return Method::Snapshots;
+    if (name == "qr")        return Method::QR;
+    if (name == "randomized") return Method::Randomized;
+    throw std::runtime_error("Unknown POD method: " + name);
+}
+
+const char* POD::methodName(Method method) {
+    switch (method) {
+        case Method::Auto:      return "auto";
+        case Method::Jacobi:    return "jacobi";
+        case Method::BDC:       return "bdc";
+        case Method::Snapshots: return "snapshots";
+        case Method::QR:        return "qr";
+        case Method::Randomized: return "randomized";
+    }
+    return "unknown";
+}
+
+Eigen::VectorXd POD::svdJacobi(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const {
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(X, Eigen::ComputeThinU);
+    int r = std::min<int>(svd.singularValues().size(), k_);
+    U = svd.matrixU().leftCols(r);
+    return svd.singularValues();
+}
+
+Eigen::VectorXd POD::svdBDC(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const {
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(X, Eigen::ComputeThinU);
+    int r = std::min<int>(svd.singularValues().size(), k_);
+    U = svd.matrixU().leftCols(r);
+    return svd.singularValues();
+}
+
+// X^T X = V S^2 V^T, so U = X V S^{-1}. Only the k_ leading columns are
+// formed, and modes at round-off level are dropped because S^{-1} would
+// amplify noise there.
+Eigen::VectorXd POD::svdSnapshots(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const {
+    Eigen::MatrixXd G = parallelGram(X);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eig(G);
+    if (eig.info() != Eigen::Success)
+        throw std::runtime_error("[POD] Gram eigendecomposition failed");
+
+    // Eigenvalues come back ascending; flip to descending singular values.
+    const Eigen::Index m = G.rows();
+    Eigen::VectorXd S(m);
+    Eigen::MatrixXd V(m, m);
+    for (Eigen::Index i = 0; i < m; i++) {
+        S(i) = std::sqrt(std::max(0.0, eig.eigenvalues()(m-1-i)));
+        V.col(i) = eig.eigenvectors().col(m-1-i);
+    }
+
+    double tol = S.size() > 0 ? S(0) * m * 1e-8 : 0.0;
+    int r = 0;
+    while (r < std::min<int>(m, k_) && S(r) > tol)
+        r++;
+
+    Eigen::MatrixXd W = V.leftCols(r) * S.head(r).cwiseInverse().asDiagonal();
+    U = parallelMultiply(X, W);
+    return S;
+}
+
+// X = Q R, R = Ur S V^T  =>  X = (Q Ur) S V^T
+Eigen::VectorXd POD::svdQR(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const {
+    const Eigen::Index n = X.rows(), m = X.cols();
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(X);
+    Eigen::MatrixXd R = qr.matrixQR().topRows(m).triangularView<Eigen::Upper>();
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(R, Eigen::ComputeThinU);
+
+    // Apply the Householder reflectors to [Ur_k; 0] rather than forming Q.
+    int r = std::min<int>(svd.singularValues().size(), k_);
+    U = Eigen::MatrixXd::Zero(n, r);
+    U.topRows(m) = svd.matrixU().leftCols(r);
+    U.applyOnTheLeft(qr.householderQ());
+    return svd.singularValues();
+}
+
+// Orthonormal basis of range(Y), n x l
+static Eigen::MatrixXd orthonormalize(const Eigen::MatrixXd& Y) {
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(Y);
+    return qr.householderQ() * Eigen::MatrixXd::Identity(Y.rows(), Y.cols());
+}
+
+// Randomized range finder (Halko, Martinsson & Tropp): Q spans X * Omega
+// after q power iterations, B = Q^T X is small (l x m), and X ~ (Q Ub) S V^T.
+// Every pass over X is a row-blocked parallel GEMM.
+Eigen::VectorXd POD::svdRandomized(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const {
+    const Eigen::Index n = X.rows(), m = X.cols();
+    Eigen::Index l = std::min<Eigen::Index>({k_ + oversampling_, n, m});
+
+    std::mt19937_64 rng(seed_);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    Eigen::MatrixXd Omega(m, l);
+    for (Eigen::Index j = 0; j < l; j++)
+        for (Eigen::Index i = 0; i < m; i++)
+            Omega(i, j) = gauss(rng);
+
+    Eigen::MatrixXd Q = orthonormalize(parallelMultiply(X, Omega));
+    for (int it = 0; it < powerIterations_; it++) {
+        // Re-orthonormalize between passes so small singular directions
+        // are not lost to round-off.
+        Eigen::MatrixXd Z = orthonormalize(parallelTransposeMultiply(X, Q));
+        Q = orthonormalize(parallelMultiply(X, Z));
+    }
+
+    Eigen::MatrixXd B = parallelTransposeMultiply(Q, X); // l x m
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(B, Eigen::ComputeThinU);
+    int r = std::min<int>(svd.singularValues().size(), k_);
+    U = parallelMultiply(Q, svd.matrixU().leftCols(r));
+    return svd.singularValues();
+}
+
+void POD::computeBasis(const Eigen::Ref<const Eigen::MatrixXd>& X) {
+    ScopedTimer timer("svd");
     // X is n x m
-    Eigen::JacobiSVD<Eigen::MatrixXd> svd(
-        X, Eigen::ComputeThinU | Eigen::ComputeThinV
-    );
-    const auto& U = svd.matrixU();
-    const auto& S = svd.singularValues();
-    int rank = std::min<int>(S.size(), k_);
-    basis_ = U.leftCols(rank).eval();
-    std::cout << "[POD] Computed basis with rank="<<rank<<"\n";
+    lastMethod_ = (method_ == Method::Auto) ? resolveMethod(X.rows(), X.cols())
+                                            : method_;
+    // The QR path needs n >= m
+    if (lastMethod_ == Method::QR && X.rows() < X.cols())
+        lastMethod_ = Method::BDC;
+
+    auto t0 = std::chrono::steady_clock::now();
+    Eigen::MatrixXd U;
+    Eigen::VectorXd S;
+    switch (lastMethod_) {
+        case Method::Jacobi:    S = svdJacobi(X, U);    break;
+        case Method::BDC:       S = svdBDC(X, U);       break;
+        case Method::Snapshots: S = svdSnapshots(X, U); break;
+        case Method::QR:        S = svdQR(X, U);        break;
+        case Method::Randomized: S = svdRandomized(X, U); break;
+        case Method::Auto:      break; // resolved above
+    }
+    double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0).count();
+
+    singularValues_ = S;
+    totalEnergy_ = X.squaredNorm();
+    int rank = chooseRank(U.cols());
+    errorEstimate_ = std::sqrt(std::max(0.0, 1.0 - capturedEnergy(rank)));
+
+    basis_ = U.leftCols(rank);
+    std::cout << "[POD] Computed basis with rank="<<rank
+              << " (" << methodName(lastMethod_) << ", " << secs << " s)"
+              << ", relative projection error " << errorEstimate_ << "\n";
+}
+
+void POD::computeBasisOutOfCore(const std::string& snapshotFile,
+                                const std::string& basisFile,
+                                Eigen::Index blockRows)
+{
+    ScopedTimer timer("svd");
+    auto t0 = std::chrono::steady_clock::now();
+    SnapshotReader reader(snapshotFile);
+    double total = 0.0;
+    Eigen::MatrixXd R = tsqrR(reader, blockRows, &total);
+
+    // X = Q R and R = Ur S V^T, so the left singular vectors Q Ur equal
+    // X V S^{-1}; that second pass avoids storing Q.
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(R, Eigen::ComputeThinV);
+    const Eigen::VectorXd& S = svd.singularValues();
+    double tol = S.size() > 0 ? S(0) * R.cols() * 1e-8 : 0.0;
+    int r = 0;
+    while (r < std::min<int>(S.size(), k_) && S(r) > tol)
+        r++;
+    singularValues_ = S;
+    totalEnergy_ = total;
+    r = chooseRank(r);
+    Eigen::MatrixXd W = svd.matrixV().leftCols(r) * S.head(r).cwiseInverse().asDiagonal();
+
+    basis_.resize(reader.rows(), r);
+    SnapshotWriter writer(basisFile, reader.rows(), r);
+    reader.rewind();
+    Eigen::MatrixXd block;
+    Eigen::Index row = 0;
+    while (reader.readRows(blockRows, block) > 0) {
+        Eigen::MatrixXd Ub = parallelMultiply(block, W);
+        writer.writeRows(Ub);
+        basis_.middleRows(row, Ub.rows()) = Ub;
+        row += Ub.rows();
+    }
+    writer.close();
+
+    double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0).count();
+    errorEstimate_ = std::sqrt(std::max(0.0, 1.0 - capturedEnergy(r)));
+    std::cout << "[POD] Computed out-of-core basis with rank="<<r
+              << " (tsqr, " << secs << " s)"
+              << ", relative projection error " << errorEstimate_
+              << ", written to " << basisFile << "\n";
+}
+
+int POD::enrich(const Eigen::MatrixXd& S, double tol, int maxModes) {
+    int added = 0;
+    for (Eigen::Index c = 0; c < S.cols() && basis_.cols() < maxModes; c++) {
+        Eigen::VectorXd r = S.col(c);
+        double norm0 = r.norm();
+        for (int pass = 0; pass < 2; pass++)
+            r -= basis_ * (basis_.transpose() * r);
+        double norm = r.norm();
+        if (norm <= tol * norm0 || norm0 == 0.0)
+            continue;
+        basis_.conservativeResize(Eigen::NoChange, basis_.cols() + 1);
+        basis_.col(basis_.cols() - 1) = r / norm;
+        added++;
+    }
+    return added;
+}
+
+void POD::saveBasis(const std::string& file) const {
+    ScopedTimer timer("snapshotIO");
+    SnapshotWriter writer(file, basis_.rows(), basis_.cols());
+    writer.writeRows(basis_);
+    writer.close();
+}
+
+void POD::loadBasis(const std::string& file) {
+    basis_ = loadSnapshotMatrix(file);
 }
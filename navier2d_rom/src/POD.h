@@ -1,17 +1,111 @@
 #pragma once
 #include <Eigen/Dense>
+#include <functional>
+#include <ostream>
+#include <string>
 
 class POD {
 public:
-    POD(int numModes);
+    // SVD backend used by computeBasis
+    enum class Method {
+        Auto,       // choose from the matrix shape (see resolveMethod)
+        Jacobi,     // Eigen::JacobiSVD on X: most accurate, slowest
+        BDC,        // Eigen::BDCSVD on X: divide and conquer
+        Snapshots,  // method of snapshots: eigendecomposition of X^T X
+        QR,         // thin Householder QR of X, then SVD of the m x m R
+        Randomized  // Gaussian sketch + power iterations, SVD of a small l x m matrix
+    };
 
-    // Compute basis from snapshots X (n x m)
-    void computeBasis(const Eigen::MatrixXd& X);
+    POD(int numModes, Method method = Method::Auto);
+
+    // Compute basis from snapshots X (n x m); any column-major block or
+    // mapped buffer is used in place
+    void computeBasis(const Eigen::Ref<const Eigen::MatrixXd>& X);
+
+    // Out-of-core variant for snapshot files larger than memory: streams
+    // row blocks of snapshotFile (text or binary) through a TSQR, takes the
+    // SVD of the m x m R factor, then streams X again to form
+    // U = X V S^{-1} block by block into basisFile (binary snapshot format).
+    // Memory use is about numThreads() * blockRows * m doubles plus the basis.
+    void computeBasisOutOfCore(const std::string& snapshotFile,
+                               const std::string& basisFile,
+                               Eigen::Index blockRows);
+
+    // Enrich the basis with new snapshots S (n x s): each column's component
+    // orthogonal to the current basis (twice Gram-Schmidt) is appended as a
+    // new mode if it is larger than tol * ||s||, up to maxModes in total.
+    // Returns the number of modes added. Reduced operators built on this
+    // basis must be reassembled afterwards.
+    int enrich(const Eigen::MatrixXd& S, double tol, int maxModes);
+
+    // Basis I/O (binary snapshot format, n x k)
+    void saveBasis(const std::string& file) const;
+    void loadBasis(const std::string& file);
+
+    // Energy-based truncation: keep the smallest k whose singular values
+    // capture at least this fraction of ||X||_F^2 (e.g. 0.9999). numModes
+    // from the constructor then only caps k. 0 (default) keeps numModes.
+    void setEnergyThreshold(double fraction);
+
+    // Randomized backend: sketch size is numModes + oversampling; each
+    // power iteration costs two more passes over X. The sketch is drawn from
+    // a seeded generator, so results do not depend on the thread count.
+    void setRandomizedOptions(int oversampling, int powerIterations, unsigned seed);
 
     // Return the POD basis matrix (n x k)
     const Eigen::MatrixXd& basis() const { return basis_; }
 
+    // Number of retained modes k (may differ from numModes, see above)
+    int numModes() const { return basis_.cols(); }
+
+    // Singular values from the last computeBasis call (at least the
+    // retained ones; all of them for the full-SVD backends)
+    const Eigen::VectorXd& singularValues() const { return singularValues_; }
+
+    // Fraction of ||X||_F^2 captured by the first k modes
+    double capturedEnergy(int k) const;
+
+    // Table of k vs sigma_k vs captured energy vs predicted online cost per
+    // step (flopsPerStep(k), e.g. GalerkinROM::estimateFlopsPerStep).
+    void printTruncationReport(std::ostream& os,
+                               const std::function<double(int)>& flopsPerStep,
+                               int maxRows = 50) const;
+
+    // Backend actually used by the last computeBasis call
+    Method lastMethod() const { return lastMethod_; }
+
+    // A-posteriori relative projection error of the last computeBasis call,
+    // ||X - U U^T X||_F / ||X||_F = sqrt(1 - sum_{i<k} s_i^2 / ||X||_F^2).
+    // Exact for every backend: the s_i are the singular values of U^T X.
+    double errorEstimate() const { return errorEstimate_; }
+
+    // Backend Auto picks for an n x m snapshot matrix
+    static Method resolveMethod(Eigen::Index n, Eigen::Index m);
+
+    // "auto", "jacobi", "bdc", "snapshots", "qr", "randomized"
+    static Method methodFromString(const std::string& name);
+    static const char* methodName(Method method);
+
 private:
     int k_;
+    Method method_;
+    Method lastMethod_;
+    int oversampling_ = 10;
+    int powerIterations_ = 2;
+    unsigned seed_ = 42;
+    double energyThreshold_ = 0.0;
+    double errorEstimate_ = 0.0;
+    double totalEnergy_ = 0.0;       // ||X||_F^2
+    Eigen::VectorXd singularValues_;
     Eigen::MatrixXd basis_;  // n x k
+
+    int chooseRank(int available) const;
+
+    // Each backend returns the leading singular values and fills U with
+    // (at most) the matching k_ left singular vectors.
+    Eigen::VectorXd svdJacobi(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const;
+    Eigen::VectorXd svdBDC(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const;
+    Eigen::VectorXd svdSnapshots(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const;
+    Eigen::VectorXd svdQR(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const;
+    Eigen::VectorXd svdRandomized(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& U) const;
 };
@@ -0,0 +1,66 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static std::atomic<int> g_numThreads{0};
+
+void setNumThreads(int n) {
+    g_numThreads = std::max(0, n);
+}
+
+int numThreads() {
+    int n = g_numThreads.load();
+    if (n > 0)
+        return n;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? static_cast<int>(hw) : 1;
+}
+
+void parallelFor(int begin, int end, const std::function<void(int)>& fn,
+                 int maxThreads)
+{
+    int count = end - begin;
+    if (count <= 0)
+        return;
+    int workers = std::min(count, maxThreads > 0 ? maxThreads : numThreads());
+    if (workers <= 1) {
+        for (int i = begin; i < end; i++)
+            fn(i);
+        return;
+    }
+
+    std::atomic<int> next{begin};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto work = [&]() {
+        for (;;) {
+            int i = next.fetch_add(1);
+            if (i >= end)
+                return;
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                next = end; // stop handing out work
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (int t = 1; t < workers; t++)
+        pool.emplace_back(work);
+    work();
+    for (auto& th : pool)
+        th.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <functional>
+
+// Minimal std::thread helpers shared by the parallel stages
+// (parameter sweeps, POD GEMMs, ...).
+
+// Process-wide worker count; 0 means std::thread::hardware_concurrency().
+void setNumThreads(int n);
+int numThreads();
+
+// Call fn(i) for every i in [begin, end) using up to maxThreads workers
+// (0 = numThreads()). Indices are handed out dynamically, so uneven work
+// items balance on their own. The first exception thrown by fn is
+// rethrown on the calling thread once all workers have stopped.
+void parallelFor(int begin, int end, const std::function<void(int)>& fn,
+                 int maxThreads = 0);
@@ -0,0 +1,68 @@
+#include "ParallelLinAlg.h"
+#include <algorithm>
+#include <vector>
+#include "Parallel.h"
+
+// Split n rows into roughly equal blocks, a few per thread for balance but
+// never so small that the per-block GEMM overhead dominates.
+static int numRowBlocks(Eigen::Index n) {
+    const Eigen::Index minRows = 256;
+    Eigen::Index blocks = std::min<Eigen::Index>(4*numThreads(), n / minRows);
+    return static_cast<int>(std::max<Eigen::Index>(1, blocks));
+}
+
+static Eigen::Index blockStart(Eigen::Index n, int blocks, int b) {
+    return n * b / blocks;
+}
+
+Eigen::MatrixXd parallelGram(const Eigen::Ref<const Eigen::MatrixXd>& X) {
+    const Eigen::Index n = X.rows(), m = X.cols();
+    int blocks = numRowBlocks(n);
+    std::vector<Eigen::MatrixXd> partial(blocks);
+
+    parallelFor(0, blocks, [&](int b) {
+        Eigen::Index r0 = blockStart(n, blocks, b);
+        Eigen::Index r1 = blockStart(n, blocks, b + 1);
+        partial[b] = Eigen::MatrixXd::Zero(m, m);
+        partial[b].selfadjointView<Eigen::Lower>()
+            .rankUpdate(X.middleRows(r0, r1 - r0).transpose());
+    });
+
+    Eigen::MatrixXd G = Eigen::MatrixXd::Zero(m, m);
+    for (const auto& P : partial)
+        G += P;
+    return G.selfadjointView<Eigen::Lower>();
+}
+
+Eigen::MatrixXd parallelMultiply(const Eigen::Ref<const Eigen::MatrixXd>& A, const Eigen::Ref<const Eigen::MatrixXd>& B) {
+    const Eigen::Index n = A.rows();
+    Eigen::MatrixXd C(n, B.cols());
+    int blocks = numRowBlocks(n);
+
+    parallelFor(0, blocks, [&](int b) {
+        Eigen::Index r0 = blockStart(n, blocks, b);
+        Eigen::Index r1 = blockStart(n, blocks, b + 1);
+        C.middleRows(r0, r1 - r0).noalias() = A.middleRows(r0, r1 - r0) * B;
+    });
+    return C;
+}
+
+Eigen::MatrixXd parallelTransposeMultiply(const Eigen::Ref<const Eigen::MatrixXd>& A,
+                                          const Eigen::Ref<const Eigen::MatrixXd>& B)
+{
+    const Eigen::Index n = A.rows();
+    int blocks = numRowBlocks(n);
+    std::vector<Eigen::MatrixXd> partial(blocks);
+
+    parallelFor(0, blocks, [&](int b) {
+        Eigen::Index r0 = blockStart(n, blocks, b);
+        Eigen::Index r1 = blockStart(n, blocks, b + 1);
+        partial[b].noalias() = A.middleRows(r0, r1 - r0).transpose()
+                             * B.middleRows(r0, r1 - r0);
+    });
+
+    Eigen::MatrixXd C = Eigen::MatrixXd::Zero(A.cols(), B.cols());
+    for (const auto& P : partial)
+        C += P;
+    return C;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <Eigen/Dense>
+
+// Dense products split over row blocks and run with parallelFor (Eigen's
+// own GEMM is only multithreaded under OpenMP, which this build does not
+// use). All of them target tall operands: the row count n is large and the
+// column counts are small enough for per-thread partial results. Operands
+// are taken as Refs, so blocks and mapped buffers are not copied.
+
+// X^T X (m x m) for a tall X (n x m); each thread accumulates a partial
+// Gram matrix of its row block with a symmetric rank update.
+Eigen::MatrixXd parallelGram(const Eigen::Ref<const Eigen::MatrixXd>& X);
+
+// A * B (n x l) for a tall A (n x m); row blocks of the result are independent.
+Eigen::MatrixXd parallelMultiply(const Eigen::Ref<const Eigen::MatrixXd>& A, const Eigen::Ref<const Eigen::MatrixXd>& B);
+
+// A^T * B (m x l) for tall A (n x m) and B (n x l); reduced over row blocks.
+Eigen::MatrixXd parallelTransposeMultiply(const Eigen::Ref<const Eigen::MatrixXd>& A,
+                                          const Eigen::Ref<const Eigen::MatrixXd>& B);
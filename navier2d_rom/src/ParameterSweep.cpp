@@ -0,0 +1,202 @@
+#include "ParameterSweep.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include "Instrumentation.h"
+#include "OfflineSolver2D.h"
+#include "Parallel.h"
+#include "SnapshotIO.h"
+#include "Util.h"
+
+SweepSpec SweepSpec::fromTXT(const std::string& filename)
+{
+    std::ifstream ifs(filename);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Cannot open sweep file: " + filename);
+    }
+
+    SweepSpec spec;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(stripComment(line));
+        std::string key;
+        if (!(iss >> key))
+            continue;
+
+        auto readList = [&](std::vector<double>& values) {
+            double v;
+            while (iss >> v)
+                values.push_back(v);
+            if (values.empty())
+                throw std::runtime_error("Empty value list for " + key);
+        };
+
+        bool ok = true;
+        if (key == "viscosity")
+            readList(spec.viscosities);
+        else if (key == "swirlRadius")
+            readList(spec.swirlRadii);
+        else if (key == "swirlAmplitude")
+            readList(spec.swirlAmplitudes);
+        else if (key == "threads")
+            ok = static_cast<bool>(iss >> spec.threads);
+        else if (key == "memoryMB")
+            ok = static_cast<bool>(iss >> spec.memoryMB);
+        else if (key == "database")
+            ok = static_cast<bool>(iss >> spec.databaseFile);
+        else if (key == "manifest")
+            ok = static_cast<bool>(iss >> spec.manifestFile);
+        else
+            throw std::runtime_error("Unknown sweep key: " + key);
+        if (!ok)
+            throw std::runtime_error("Error reading " + key);
+    }
+    return spec;
+}
+
+ParameterSweep::ParameterSweep(const Config& base, const SweepSpec& spec)
+    : base_(base), spec_(spec)
+{}
+
+std::vector<Config> ParameterSweep::expandGrid() const {
+    auto orBase = [](const std::vector<double>& v, double base) {
+        return v.empty() ? std::vector<double>{base} : v;
+    };
+    std::vector<double> nus  = orBase(spec_.viscosities, base_.viscosity);
+    std::vector<double> rads = orBase(spec_.swirlRadii, base_.swirlRadius);
+    std::vector<double> amps = orBase(spec_.swirlAmplitudes, base_.swirlAmplitude);
+
+    std::vector<Config> grid;
+    for (double nu : nus) {
+        for (double r : rads) {
+            for (double a : amps) {
+                Config cfg = base_;
+                cfg.viscosity = nu;
+                cfg.swirlRadius = r;
+                cfg.swirlAmplitude = a;
+                grid.push_back(cfg);
+            }
+        }
+    }
+    return grid;
+}
+
+// Concurrent runs allowed by the thread count and the memory budget.
+// A run holds its full snapshot set in memory until it is written.
+int ParameterSweep::concurrentRuns(const Config& cfg) const {
+    double cells = static_cast<double>(cfg.Nx) * cfg.Ny;
+    int steps = static_cast<int>(std::ceil(cfg.finalTime/cfg.dt));
+    double numSnapshots = steps / cfg.snapshotInterval + 2;
+    double bytesPerRun = 8.0 * (4*cells + 2*cells*numSnapshots);
+
+    int byThreads = spec_.threads > 0 ? spec_.threads : numThreads();
+    int byMemory = static_cast<int>(spec_.memoryMB * 1024.0 * 1024.0 / bytesPerRun);
+    if (byMemory < 1) {
+        std::cerr << "[ParameterSweep] Warning: one run needs "
+                  << bytesPerRun / (1024.0*1024.0) << " MB, above the "
+                  << spec_.memoryMB << " MB budget; running serially\n";
+        byMemory = 1;
+    }
+    return std::max(1, std::min(byThreads, byMemory));
+}
+
+void ParameterSweep::run() {
+    std::vector<Config> grid = expandGrid();
+    int workers = concurrentRuns(base_);
+    std::cout << "[ParameterSweep] " << grid.size() << " runs, "
+              << workers << " concurrent\n";
+
+    std::ofstream db(spec_.databaseFile, std::ios::binary | std::ios::trunc);
+    if (!db.is_open())
+        throw std::runtime_error("Cannot open " + spec_.databaseFile);
+
+    runs_.assign(grid.size(), SweepRun{});
+    long long offset = 0;
+    std::mutex dbMutex;
+
+    parallelFor(0, static_cast<int>(grid.size()), [&](int r) {
+        const Config& cfg = grid[r];
+        ScopedTimer timer("case");
+        auto t0 = std::chrono::steady_clock::now();
+        OfflineSolver2D solver(cfg);
+        solver.simulate();
+        double wall = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        SweepRun info;
+        info.id = r;
+        info.viscosity = cfg.viscosity;
+        info.swirlRadius = cfg.swirlRadius;
+        info.swirlAmplitude = cfg.swirlAmplitude;
+        info.rows = solver.snapshots().empty() ? 0 : solver.snapshots()[0].size();
+        info.cols = solver.snapshots().size();
+        info.wallSeconds = wall;
+        info.times = solver.snapshotTimes();
+
+        {
+            // Blocks are appended in completion order; the manifest keeps
+            // the offsets so readers never need to scan the database.
+            std::lock_guard<std::mutex> lock(dbMutex);
+            info.offset = offset;
+            info.bytes = writeBinarySnapshots(db, solver.snapshots());
+            offset += info.bytes;
+        }
+        solver.clearSnapshots();
+        runs_[r] = info;
+
+        std::cout << "[ParameterSweep] run " << r << " (nu=" << cfg.viscosity
+                  << ", R=" << cfg.swirlRadius << ", A=" << cfg.swirlAmplitude
+                  << ") done in " << wall << " s\n";
+    }, workers);
+
+    db.close();
+    writeManifest();
+    std::cout << "[ParameterSweep] Wrote " << spec_.databaseFile
+              << " and " << spec_.manifestFile << std::endl;
+}
+
+void ParameterSweep::writeManifest() const {
+    std::ofstream ofs(spec_.manifestFile);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + spec_.manifestFile);
+    ofs.precision(17);
+    ofs << "# database " << spec_.databaseFile << "\n";
+    ofs << "# id viscosity swirlRadius swirlAmplitude rows cols offset bytes"
+           " wallSeconds times...\n";
+    for (const auto& r : runs_) {
+        ofs << r.id << " " << r.viscosity << " " << r.swirlRadius << " "
+            << r.swirlAmplitude << " " << r.rows << " " << r.cols << " "
+            << r.offset << " " << r.bytes << " " << r.wallSeconds;
+        for (double t : r.times)
+            ofs << " " << t;
+        ofs << "\n";
+    }
+}
+
+std::vector<SweepRun> ParameterSweep::readManifest(const std::string& filename) {
+    std::ifstream ifs(filename);
+    if (!ifs.is_open())
+        throw std::runtime_error("Cannot open manifest: " + filename);
+
+    std::vector<SweepRun> runs;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(stripComment(line));
+        SweepRun r;
+        if (!(iss >> r.id))
+            continue;
+        if (!(iss >> r.viscosity >> r.swirlRadius >> r.swirlAmplitude
+                  >> r.rows >> r.cols >> r.offset >> r.bytes >> r.wallSeconds))
+            throw std::runtime_error("Malformed manifest line in " + filename);
+        double t;
+        while (iss >> t)
+            r.times.push_back(t);
+        runs.push_back(r);
+    }
+    return runs;
+}
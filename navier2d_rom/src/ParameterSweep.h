@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Config.h"
+
+// Sweep description read from a plain text file, one "key values..." entry
+// per line ('#' starts a comment):
+//
+//     viscosity       0.01 0.005 0.0025   # every listed value is swept
+//     swirlRadius     0.2 0.25
+//     swirlAmplitude  1.0
+//     threads         4                   # concurrent runs (0 = numThreads())
+//     memoryMB        2048                # budget for runs held in memory
+//     database        sweep_db.bin
+//     manifest        sweep_manifest.txt
+//
+// The run list is the Cartesian product of the parameter lists; parameters
+// that are not listed keep their value from the base Config.
+struct SweepSpec
+{
+    std::vector<double> viscosities;
+    std::vector<double> swirlRadii;
+    std::vector<double> swirlAmplitudes;
+
+    int threads = 0;
+    double memoryMB = 1024.0;
+
+    std::string databaseFile = "sweep_db.bin";
+    std::string manifestFile = "sweep_manifest.txt";
+
+    static SweepSpec fromTXT(const std::string& filename);
+};
+
+// One entry of the snapshot database manifest
+struct SweepRun
+{
+    int id;
+    double viscosity, swirlRadius, swirlAmplitude;
+    int rows, cols;
+    long long offset;   // byte offset of the run's binary block in the database
+    long long bytes;    // size of that block
+    double wallSeconds;
+    std::vector<double> times;
+};
+
+// Runs OfflineSolver2D for every point of the sweep grid concurrently and
+// appends each run's snapshots to a single binary database file (see
+// SnapshotIO.h for the block layout), plus a text manifest indexing it.
+class ParameterSweep {
+public:
+    ParameterSweep(const Config& base, const SweepSpec& spec);
+
+    // Run all sweep points and write the database and manifest
+    void run();
+
+    const std::vector<SweepRun>& runs() const { return runs_; }
+
+    // Read a manifest written by run()
+    static std::vector<SweepRun> readManifest(const std::string& filename);
+
+private:
+    Config base_;
+    SweepSpec spec_;
+    std::vector<SweepRun> runs_;
+
+    std::vector<Config> expandGrid() const;
+    int concurrentRuns(const Config& cfg) const;
+    void writeManifest() const;
+};
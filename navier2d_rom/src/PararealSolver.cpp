@@ -0,0 +1,136 @@
+#include "PararealSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include "Instrumentation.h"
+#include "Parallel.h"
+#include "Util.h"
+
+PararealSolver::PararealSolver(const Config& cfg, int slices)
+    : cfg_(cfg)
+{
+    const int steps = static_cast<int>(std::ceil(cfg_.finalTime/cfg_.dt));
+    slices_ = std::clamp(slices > 0 ? slices : numThreads(), 1, std::max(1, steps));
+    maxIterations_ = cfg_.pararealMaxIterations > 0
+                   ? std::min(cfg_.pararealMaxIterations, slices_) : slices_;
+    if (cfg_.pararealCoarseFactor < 1)
+        throw std::runtime_error("PararealSolver: pararealCoarseFactor must be >= 1");
+
+    // Fine steps split as evenly as possible; slice boundaries stay on the
+    // fine time grid, so the converged result is the serial solve
+    for (int p = 0; p < slices_; p++)
+        sliceSteps_.push_back((p + 1)*steps/slices_ - p*steps/slices_);
+
+    for (int p = 0; p < slices_; p++)
+        fine_.push_back(std::make_unique<OfflineSolver2D>(cfg_));
+    coarse_.resize(slices_);
+}
+
+int PararealSolver::coarseSteps(int slice) const {
+    return std::max(1, (sliceSteps_[slice] + cfg_.pararealCoarseFactor - 1) / cfg_.pararealCoarseFactor);
+}
+
+Eigen::VectorXd PararealSolver::fine(int slice, const Eigen::VectorXd& x) {
+    fine_[slice]->setState(x);
+    fine_[slice]->advance(sliceSteps_[slice]);
+    return fine_[slice]->state();
+}
+
+Eigen::VectorXd PararealSolver::coarse(int slice, const Eigen::VectorXd& x) {
+    const int m = coarseSteps(slice);
+    if (!rom_) {
+        // Created on first use; the coarse sweeps are serial
+        if (!coarse_[slice]) {
+            Config coarseCfg = cfg_;
+            coarseCfg.dt = sliceSteps_[slice]*cfg_.dt / m;
+            coarse_[slice] = std::make_unique<OfflineSolver2D>(coarseCfg);
+        }
+        coarse_[slice]->setState(x);
+        coarse_[slice]->advance(m);
+        return coarse_[slice]->state();
+    }
+    const Eigen::MatrixXd& Phi = rom_->pod().basis();
+    const double dt = sliceSteps_[slice]*cfg_.dt / m;
+    Eigen::VectorXd a = Phi.transpose() * x;
+    for (int s = 0; s < m; s++)
+        a = rom_->stepExplicitEuler(a, dt);
+    return Phi*a;
+}
+
+Eigen::VectorXd PararealSolver::solve(const Eigen::VectorXd& x0) {
+    ScopedTimer timer("pararealSolve");
+    const auto t0 = std::chrono::steady_clock::now();
+    stats_ = Stats{};
+    stats_.slices = slices_;
+    const int P = slices_;
+
+    // U[p] = state at the start of slice p (U[P] = final state), Gold[p] =
+    // G(U[p]) from the previous sweep, F[p] = F(U[p]) of this iteration
+    std::vector<Eigen::VectorXd> U(P + 1), Gold(P), F(P);
+    double coarseSeconds = 0.0, fineSeconds = 0.0;
+    int coarseCalls = 0, fineCalls = 0;
+
+    auto tc = std::chrono::steady_clock::now();
+    U[0] = x0;
+    for (int p = 0; p < P; p++) {
+        Gold[p] = coarse(p, U[p]);
+        U[p + 1] = Gold[p];
+    }
+    coarseSeconds += secondsSince(tc);
+    coarseCalls += P;
+
+    std::vector<double> sliceSeconds(P, 0.0);
+    for (int k = 1; k <= maxIterations_; k++) {
+        // Slices before k-1 are exact already
+        const int first = k - 1;
+        parallelFor(first, P, [&](int p) {
+            auto ts = std::chrono::steady_clock::now();
+            F[p] = fine(p, U[p]);
+            sliceSeconds[p] = secondsSince(ts);
+        });
+        for (int p = first; p < P; p++)
+            fineSeconds += sliceSeconds[p];
+        fineCalls += P - first;
+
+        // Serial correction sweep; U[first] has not moved, so its slice
+        // needs no new coarse solve and U[first+1] becomes exact
+        tc = std::chrono::steady_clock::now();
+        double change = 0.0;
+        for (int p = first; p < P; p++) {
+            Eigen::VectorXd g = (p == first) ? Gold[p] : coarse(p, U[p]);
+            if (p != first)
+                coarseCalls++;
+            Eigen::VectorXd next = g + F[p] - Gold[p];
+            change = std::max(change, (next - U[p + 1]).norm() / (next.norm() + 1e-300));
+            U[p + 1] = std::move(next);
+            Gold[p] = std::move(g);
+        }
+        coarseSeconds += secondsSince(tc);
+
+        stats_.iterations = k;
+        stats_.change.push_back(change);
+        std::cout << "[PararealSolver] Iteration " << k << ": max relative update " << change << "\n";
+        if (change <= cfg_.pararealTolerance || k == P) {
+            stats_.converged = true;
+            break;
+        }
+    }
+
+    stats_.wallSeconds = secondsSince(t0);
+    stats_.fineSliceSeconds = fineSeconds / std::max(1, fineCalls);
+    stats_.coarseSliceSeconds = coarseSeconds / std::max(1, coarseCalls);
+    double serial = P*stats_.fineSliceSeconds;
+    double parallel = (stats_.iterations + 1)*P*stats_.coarseSliceSeconds
+                    + stats_.iterations*stats_.fineSliceSeconds;
+    stats_.modelSpeedup = serial / (parallel + 1e-300);
+
+    std::cout << "[PararealSolver] " << (stats_.converged ? "Converged" : "Stopped") << " after "
+              << stats_.iterations << " iterations on " << P << " slices ("
+              << (rom_ ? "reduced" : "coarse full-order") << " coarse propagator); "
+              << "fine slice " << stats_.fineSliceSeconds << " s, coarse slice "
+              << stats_.coarseSliceSeconds << " s, model speedup on " << P
+              << " workers " << stats_.modelSpeedup << "\n";
+    return U[P];
+}
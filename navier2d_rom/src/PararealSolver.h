@@ -0,0 +1,66 @@
+#pragma once
+#include <Eigen/Dense>
+#include <memory>
+#include <vector>
+#include "Config.h"
+#include "OfflineSolver2D.h"
+#include "ReducedDynamics.h"
+
+// Parareal time-parallel full-order solve. [0, finalTime] is cut into
+// slices; every iteration advances all unconverged slices with the fine
+// propagator F (OfflineSolver2D at cfg.dt) in parallel, then sweeps the
+// slice boundaries serially with the cheap coarse propagator G:
+//
+//   U_{n+1}^{k+1} = G(U_n^{k+1}) + F(U_n^k) - G(U_n^k)
+//
+// After k iterations the first k slices equal the serial solve exactly,
+// so at most `slices` iterations reproduce it; convergence is declared
+// when no slice boundary moves by more than cfg.pararealTolerance
+// (relative).
+//
+// G is either a reduced model (Phi Euler^m(Phi^T x), any ReducedDynamics)
+// or, without one, OfflineSolver2D with a time step cfg.pararealCoarseFactor
+// times larger, which must stay inside the explicit stability limit.
+class PararealSolver {
+public:
+    // slices <= 0 uses numThreads()
+    PararealSolver(const Config& cfg, int slices = 0);
+
+    // Use a reduced model as coarse propagator (nullptr: coarse full-order)
+    void setCoarseModel(ReducedDynamics* rom) { rom_ = rom; }
+
+    // Solve from x0 to cfg.finalTime; returns the final full state
+    Eigen::VectorXd solve(const Eigen::VectorXd& x0);
+
+    struct Stats
+    {
+        int slices = 0;
+        int iterations = 0;          // parallel fine sweeps done
+        bool converged = false;
+        std::vector<double> change;  // max relative boundary update, per iteration
+        double wallSeconds = 0.0;
+        double fineSliceSeconds = 0.0;    // mean F over one slice
+        double coarseSliceSeconds = 0.0;  // mean G over one slice
+        // Serial fine cost (slices F) over the cost of the parareal schedule
+        // on `slices` workers: (iterations+1) serial coarse sweeps plus
+        // `iterations` parallel fine sweeps
+        double modelSpeedup = 0.0;
+    };
+    const Stats& stats() const { return stats_; }
+
+private:
+    Config cfg_;
+    int slices_;
+    int maxIterations_;
+    std::vector<int> sliceSteps_;  // fine steps of each slice
+    ReducedDynamics* rom_ = nullptr;
+    Stats stats_;
+
+    // One of each per slice, so slices can run concurrently (coarse ones
+    // only without a reduced model)
+    std::vector<std::unique_ptr<OfflineSolver2D>> fine_, coarse_;
+
+    Eigen::VectorXd fine(int slice, const Eigen::VectorXd& x);
+    Eigen::VectorXd coarse(int slice, const Eigen::VectorXd& x);
+    int coarseSteps(int slice) const;
+};
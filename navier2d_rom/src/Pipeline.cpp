@@ -0,0 +1,624 @@
+#include "Pipeline.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "Config.h"
+#include "GalerkinModel.h"
+#include "GalerkinROM.h"
+#include "GreedyTrainer.h"
+#include "HybridSolver2D.h"
+#include "Instrumentation.h"
+#include "LocalGalerkinROM.h"
+#include "ModelRegistry.h"
+#include "OfflineSolver2D.h"
+#include "OnlineSolver2D.h"
+#include "POD.h"
+#include "PararealSolver.h"
+#include "RomServer.h"
+#include "Parallel.h"
+#include "ParameterSweep.h"
+#include "ScalingStudy.h"
+#include "SnapshotIO.h"
+#include "Telemetry.h"
+#include "TrajectoryValidation.h"
+
+namespace fs = std::filesystem;
+
+StageArgs StageArgs::parse(int argc, char** argv, int first) {
+    StageArgs args;
+    for (int i = first; i < argc; i++) {
+        std::string key = argv[i];
+        if (key.rfind("--", 0) != 0)
+            throw std::runtime_error("Unexpected argument: " + key);
+        key = key.substr(2);
+        bool hasValue = (i + 1 < argc) && std::string(argv[i+1]).rfind("--", 0) != 0;
+        args.values[key] = hasValue ? argv[++i] : "";
+    }
+    return args;
+}
+
+bool StageArgs::has(const std::string& key) const {
+    return values.count(key) > 0;
+}
+
+std::string StageArgs::get(const std::string& key, const std::string& fallback) const {
+    auto it = values.find(key);
+    return it == values.end() ? fallback : it->second;
+}
+
+std::string StageArgs::require(const std::string& key) const {
+    auto it = values.find(key);
+    if (it == values.end() || it->second.empty())
+        throw std::runtime_error("Missing required option --" + key);
+    return it->second;
+}
+
+// ---------------------------------------------------------------------------
+// Artifact fingerprints
+
+// Small files (configs) are hashed by content so that rewriting them
+// unchanged does not invalidate outputs; large artifacts by size and mtime.
+static std::string fingerprintFile(const std::string& path) {
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (ec)
+        throw std::runtime_error("Missing input artifact: " + path);
+
+    std::ostringstream oss;
+    oss << path << " " << size << " ";
+    if (size < (1u << 20)) {
+        std::ifstream ifs(path, std::ios::binary);
+        std::uint64_t h = 1469598103934665603ull;   // FNV-1a
+        char c;
+        while (ifs.get(c)) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        oss << std::hex << h;
+    } else {
+        oss << fs::last_write_time(path).time_since_epoch().count();
+    }
+    return oss.str();
+}
+
+static std::string fingerprint(const std::string& stage,
+                               const std::vector<std::string>& inputs,
+                               const std::string& options = "")
+{
+    std::string fp = stage + "\n" + options + "\n";
+    for (const auto& in : inputs)
+        fp += fingerprintFile(in) + "\n";
+    return fp;
+}
+
+static bool upToDate(const std::vector<std::string>& outputs, const std::string& fp) {
+    for (const auto& out : outputs)
+        if (!fs::exists(out))
+            return false;
+    std::ifstream ifs(outputs.front() + ".stamp");
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ifs.is_open() && ss.str() == fp;
+}
+
+static void writeStamp(const std::string& output, const std::string& fp) {
+    std::ofstream ofs(output + ".stamp");
+    ofs << fp;
+}
+
+static bool skipStage(const StageArgs& args, const char* stage,
+                      const std::vector<std::string>& outputs, const std::string& fp)
+{
+    if (args.has("force") || !upToDate(outputs, fp))
+        return false;
+    std::cout << "[" << stage << "] Inputs unchanged, reusing " << outputs.front() << "\n";
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Shared setup
+
+static Config loadConfig(const StageArgs& args) {
+    Config cfg = Config::fromTXT(args.get("config", "../config.txt"));
+    setNumThreads(cfg.numThreads);
+    return cfg;
+}
+
+static POD makePOD(const Config& cfg) {
+    bool outOfCore = (cfg.podMethod == "tsqr");
+    POD pod(cfg.numPodModes,
+            outOfCore ? POD::Method::Auto : POD::methodFromString(cfg.podMethod));
+    pod.setRandomizedOptions(cfg.podOversampling, cfg.podPowerIterations, cfg.podSeed);
+    pod.setEnergyThreshold(cfg.podEnergy);
+    return pod;
+}
+
+static GalerkinROM makeGalerkin(const Config& cfg, const POD& pod) {
+    double dx = cfg.dx();
+    double dy = cfg.dy();
+    return GalerkinROM(pod, cfg.Nx, cfg.Ny, dx, dy, cfg.viscosity, boundaryFromString(cfg.boundary));
+}
+
+static void attachOutputs(const Config& cfg, OnlineSolver2D& online) {
+    if (!cfg.probeFile.empty())
+        online.setProbes(OutputProbes::readPoints(cfg.probeFile));
+    if (!cfg.functionalsFile.empty())
+        online.enableFunctionals();
+}
+
+static void writeOutputs(const Config& cfg, const OnlineSolver2D& online) {
+    if (online.probes()) {
+        online.writeProbeHistory(cfg.probeOutputFile);
+        std::cout << "[pipeline] Wrote " << online.probes()->numPoints() << " probes x "
+                  << online.probeHistory().size() << " steps to " << cfg.probeOutputFile << "\n";
+    }
+    if (online.functionals()) {
+        online.writeFunctionalHistory(cfg.functionalsFile);
+        std::cout << "[pipeline] Wrote " << online.functionals()->size() << " functionals x "
+                  << online.functionalHistory().size() << " steps to " << cfg.functionalsFile << "\n";
+    }
+}
+
+static std::unique_ptr<TelemetryWriter> openTelemetry(const Config& cfg) {
+    if (cfg.telemetryFile.empty())
+        return nullptr;
+    return std::make_unique<TelemetryWriter>(cfg.telemetryFile);
+}
+
+static void closeTelemetry(const Config& cfg, TelemetryWriter* telemetry) {
+    if (!telemetry)
+        return;
+    telemetry->close();
+    std::cout << "[pipeline] Telemetry: " << telemetry->written() << " records written to "
+              << cfg.telemetryFile << " (" << telemetry->dropped() << " dropped)\n";
+}
+
+static void reportErrorIndicator(const Config& cfg, const OnlineSolver2D& online) {
+    const auto& hist = online.errorHistory();
+    if (hist.empty() || cfg.errorIndicatorFile.empty())
+        return;
+    double maxRel = 0.0;
+    for (const auto& r : hist)
+        maxRel = std::max(maxRel, r.relative);
+    online.writeErrorHistory(cfg.errorIndicatorFile);
+    std::cout << "[pipeline] Error indicator: max relative residual " << maxRel
+              << ", integrated residual " << hist.back().accumulated
+              << " (per step in " << cfg.errorIndicatorFile << ")\n";
+}
+
+static void reportTrajectoryErrors(const Config& cfg, const OnlineSolver2D& online,
+                                   const Eigen::MatrixXd& Phi, const Eigen::MatrixXd& X,
+                                   const std::vector<double>& times) {
+    if (cfg.trajectoryErrorFile.empty())
+        return;
+    const auto& hist = online.reducedHistory();
+    Eigen::MatrixXd A(Phi.cols(), hist.size());
+    for (std::size_t j = 0; j < hist.size(); j++)
+        A.col(j) = hist[j];
+    auto records = validateTrajectory(Phi, X, A, times);
+    writeTrajectoryErrors(cfg.trajectoryErrorFile, records);
+
+    double maxProj = 0.0, maxDyn = 0.0, maxTotal = 0.0;
+    for (const auto& r : records) {
+        double ref = r.reference + 1e-14;
+        maxProj = std::max(maxProj, r.projection/ref);
+        maxDyn = std::max(maxDyn, r.dynamics/ref);
+        maxTotal = std::max(maxTotal, r.total/ref);
+    }
+    std::cout << "[pipeline] Trajectory validation over " << records.size()
+              << " snapshots: max relative projection error " << maxProj
+              << ", dynamics error " << maxDyn << ", total " << maxTotal
+              << " (per snapshot in " << cfg.trajectoryErrorFile << ")\n";
+}
+
+// ---------------------------------------------------------------------------
+// Stages
+
+int runSimulate(const StageArgs& args) {
+    ScopedTimer timer("simulate", true);
+    Config cfg = loadConfig(args);
+    std::string out = args.get("snapshots", cfg.snapshotFile);
+    std::string fp = fingerprint("simulate", {args.get("config", "../config.txt")});
+    if (skipStage(args, "simulate", {out}, fp))
+        return 0;
+
+    auto telemetry = openTelemetry(cfg);
+    OfflineSolver2D offline(cfg);
+    offline.setTelemetry(telemetry.get(), cfg.telemetryInterval);
+    offline.simulate();
+    closeTelemetry(cfg, telemetry.get());
+    const auto& snaps = offline.snapshots();
+    Eigen::MatrixXd X(snaps[0].size(), snaps.size());
+    for (std::size_t c = 0; c < snaps.size(); c++)
+        X.col(c) = snaps[c];
+    saveSnapshotMatrix(out, X);
+    writeStamp(out, fp);
+    std::cout << "[simulate] Wrote " << X.cols() << " snapshots to " << out << "\n";
+    return 0;
+}
+
+int runTrain(const StageArgs& args) {
+    ScopedTimer timer("train", true);
+    Config cfg = loadConfig(args);
+    std::string snapshots = args.require("snapshots");
+    std::string basisFile = args.require("basis");
+    std::string opsFile = args.get("operators", basisFile + ".ops");
+    std::string fp = fingerprint("train", {args.get("config", "../config.txt"), snapshots});
+    if (skipStage(args, "train", {basisFile, opsFile}, fp))
+        return 0;
+
+    if (cfg.romType != "galerkin") {
+        auto model = ModelRegistry::create(cfg.romType, cfg);
+        model->train(loadSnapshotMatrix(snapshots));
+        model->save(basisFile, opsFile);
+        writeStamp(basisFile, fp);
+        std::cout << "[train] Wrote " << cfg.romType << " model to " << basisFile
+                  << " and " << opsFile << "\n";
+        return 0;
+    }
+
+    POD pod = makePOD(cfg);
+    if (cfg.podMethod == "tsqr") {
+        pod.computeBasisOutOfCore(snapshots, basisFile, cfg.podBlockRows);
+    } else {
+        pod.computeBasis(loadSnapshotMatrix(snapshots));
+        pod.saveBasis(basisFile);
+    }
+    pod.printTruncationReport(std::cout, [&](int k) {
+        return GalerkinROM::estimateFlopsPerStep(cfg.Nx, cfg.Ny, k, true);
+    });
+
+    GalerkinROM gal = makeGalerkin(cfg, pod);
+    gal.assembleReducedOperators(!cfg.errorIndicatorFile.empty());
+    gal.saveOperators(opsFile);
+    writeStamp(basisFile, fp);
+    std::cout << "[train] Wrote " << pod.numModes() << "-mode basis to " << basisFile
+              << " and operators to " << opsFile << "\n";
+    return 0;
+}
+
+int runPredict(const StageArgs& args) {
+    ScopedTimer timer("predict", true);
+    Config cfg = loadConfig(args);
+    std::string basisFile = args.require("basis");
+    std::string opsFile = args.get("operators", basisFile + ".ops");
+    std::string out = args.require("output");
+    std::vector<std::string> inputs = {args.get("config", "../config.txt"), basisFile, opsFile};
+    if (args.has("initial"))
+        inputs.push_back(args.require("initial"));
+    if (!cfg.probeFile.empty())
+        inputs.push_back(cfg.probeFile);
+    std::string fp = fingerprint("predict", inputs);
+    if (skipStage(args, "predict", {out}, fp))
+        return 0;
+
+    // Only the basis, the reduced operators and the initial states are
+    // read. Every column of the initial file is a separate query.
+    Eigen::MatrixXd X0;
+    if (args.has("initial")) {
+        X0 = loadSnapshotMatrix(args.require("initial"));
+    } else {
+        OfflineSolver2D ic(cfg);
+        X0 = ic.initialState();
+    }
+
+    auto model = ModelRegistry::create(cfg.romType, cfg);
+    model->load(basisFile, opsFile);
+    ReducedDynamics* dyn = dynamic_cast<ReducedDynamics*>(model.get());
+    if (auto* gm = dynamic_cast<GalerkinModel*>(model.get()))
+        dyn = &gm->rom();
+
+    Eigen::MatrixXd xFinal(X0.rows(), X0.cols());
+    if (X0.cols() == 1 && dyn) {
+        // A single query steps through OnlineSolver2D for the error
+        // indicator, outputs and telemetry
+        if (X0.rows() != dyn->pod().basis().rows())
+            throw std::runtime_error("Initial state does not match the basis size");
+        auto telemetry = openTelemetry(cfg);
+        OnlineSolver2D online(cfg, *dyn);
+        attachOutputs(cfg, online);
+        online.setTelemetry(telemetry.get(), cfg.telemetryInterval);
+        xFinal = online.runReducedSolve(X0.col(0));
+        closeTelemetry(cfg, telemetry.get());
+        reportErrorIndicator(cfg, online);
+        writeOutputs(cfg, online);
+    } else {
+        model->predictBatch(X0, xFinal);
+    }
+
+    saveSnapshotMatrix(out, xFinal);
+    writeStamp(out, fp);
+    std::cout << "[predict] Wrote " << xFinal.cols() << " prediction(s) to " << out << "\n";
+    return 0;
+}
+
+int runEvaluate(const StageArgs& args) {
+    ScopedTimer timer("evaluate", true);
+    std::string predFile = args.require("prediction");
+    std::string snapshots = args.require("snapshots");
+    std::string out = args.get("output");
+    std::string fp = fingerprint("evaluate", {predFile, snapshots}, args.get("column"));
+    if (!out.empty() && skipStage(args, "evaluate", {out}, fp)) {
+        std::ifstream ifs(out);
+        std::cout << ifs.rdbuf();
+        return 0;
+    }
+
+    Eigen::VectorXd pred = loadSnapshotMatrix(predFile).col(0);
+    Eigen::MatrixXd X = loadSnapshotMatrix(snapshots);
+    int col = args.has("column") ? std::stoi(args.require("column"))
+                                 : static_cast<int>(X.cols()) - 1;
+    if (col < 0 || col >= X.cols() || X.rows() != pred.size())
+        throw std::runtime_error("Prediction does not match the reference snapshots");
+    Eigen::VectorXd ref = X.col(col);
+
+    double errorNorm = (ref - pred).norm();
+    double refNorm = ref.norm();
+    std::ostringstream report;
+    report << "reference_norm " << refNorm << "\n"
+           << "prediction_norm " << pred.norm() << "\n"
+           << "relative_error " << errorNorm / (refNorm + 1e-14) << "\n";
+    std::cout << report.str();
+    if (!out.empty()) {
+        std::ofstream ofs(out);
+        ofs << report.str();
+        writeStamp(out, fp);
+    }
+    return 0;
+}
+
+int runSweep(const StageArgs& args) {
+    ScopedTimer timer("sweep", true);
+    Config base = loadConfig(args);
+    ParameterSweep sweep(base, SweepSpec::fromTXT(args.require("spec")));
+    sweep.run();
+    return 0;
+}
+
+int runScale(const StageArgs& args) {
+    ScopedTimer timer("scale", true);
+    Config base = loadConfig(args);
+    ScalingStudy study(base, ScalingSpec::fromTXT(args.require("spec")));
+    study.run();
+    return 0;
+}
+
+int runGreedy(const StageArgs& args) {
+    ScopedTimer timer("greedy", true);
+    Config base = loadConfig(args);
+    GreedyTrainer greedy(base, GreedySpec::fromTXT(args.require("spec")));
+    greedy.run();
+    return 0;
+}
+
+int runParareal(const StageArgs& args) {
+    ScopedTimer timer("parareal", true);
+    Config cfg = loadConfig(args);
+    std::string out = args.require("output");
+    std::vector<std::string> inputs = {args.get("config", "../config.txt")};
+    std::string basisFile = args.get("basis");
+    std::string opsFile = args.get("operators", basisFile + ".ops");
+    if (!basisFile.empty()) {
+        inputs.push_back(basisFile);
+        inputs.push_back(opsFile);
+    }
+    std::string fp = fingerprint("parareal", inputs);
+    if (skipStage(args, "parareal", {out}, fp))
+        return 0;
+
+    // Coarse propagator: the trained reduced model if a basis is given,
+    // otherwise the full-order model at a coarser time step
+    std::unique_ptr<ReducedOrderModel> model;
+    ReducedDynamics* dyn = nullptr;
+    if (!basisFile.empty()) {
+        model = ModelRegistry::create(cfg.romType, cfg);
+        model->load(basisFile, opsFile);
+        dyn = dynamic_cast<ReducedDynamics*>(model.get());
+        if (auto* gm = dynamic_cast<GalerkinModel*>(model.get()))
+            dyn = &gm->rom();
+        if (!dyn)
+            throw std::runtime_error("parareal: romType " + cfg.romType + " cannot be stepped");
+    }
+
+    OfflineSolver2D ic(cfg);
+    Eigen::VectorXd x0 = ic.initialState();
+    PararealSolver parareal(cfg, cfg.pararealSlices);
+    parareal.setCoarseModel(dyn);
+    Eigen::VectorXd xFinal = parareal.solve(x0);
+
+    if (args.has("reference")) {
+        // Serial fine solve for the error and the measured speedup
+        auto t0 = std::chrono::steady_clock::now();
+        OfflineSolver2D serial(cfg);
+        serial.setState(x0);
+        serial.advance(static_cast<int>(std::ceil(cfg.finalTime/cfg.dt)));
+        double serialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        Eigen::VectorXd ref = serial.state();
+        std::cout << "[parareal] Relative error vs serial solve: "
+                  << (xFinal - ref).norm() / (ref.norm() + 1e-14)
+                  << ", measured speedup " << serialSeconds / parareal.stats().wallSeconds
+                  << " (" << numThreads() << " threads)\n";
+    }
+
+    saveSnapshotMatrix(out, xFinal);
+    writeStamp(out, fp);
+    std::cout << "[parareal] Wrote final state to " << out << "\n";
+    return 0;
+}
+
+int runServe(const StageArgs& args) {
+    ScopedTimer timer("serve", true);
+    Config cfg = loadConfig(args);
+    std::string basisFile = args.require("basis");
+    POD pod(0);
+    pod.loadBasis(basisFile);
+    GalerkinROM gal = makeGalerkin(cfg, pod);
+    gal.loadOperators(args.get("operators", basisFile + ".ops"));
+
+    RomServer server(cfg, gal, args.require("socket"),
+                     std::stoi(args.get("batch-window-us", "0")));
+    server.run(std::stoi(args.get("report-every", "1000")));
+    return 0;
+}
+
+int runQuery(const StageArgs& args) {
+    ScopedTimer timer("query", true);
+    RomClient client(args.require("socket"));
+    if (args.has("shutdown")) {
+        client.shutdownServer();
+        return 0;
+    }
+
+    Eigen::VectorXd x0;
+    if (args.has("initial")) {
+        x0 = loadSnapshotMatrix(args.require("initial")).col(0);
+    } else {
+        OfflineSolver2D ic(loadConfig(args));
+        x0 = ic.initialState();
+    }
+    std::uint32_t flags = args.has("reduced") ? 0u : static_cast<std::uint32_t>(kRomFullOutput);
+    double T = std::stod(args.get("final-time", "0"));
+    double nu = std::stod(args.get("viscosity", "0"));
+    int count = std::stoi(args.get("count", "1"));
+
+    Eigen::VectorXd result;
+    std::vector<double> roundTrip;
+    for (int q = 0; q < count; q++) {
+        auto t0 = std::chrono::steady_clock::now();
+        if (client.solve(x0, flags, T, nu, result) != 0)
+            throw std::runtime_error("Server rejected the request");
+        roundTrip.push_back(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - t0).count());
+    }
+    std::sort(roundTrip.begin(), roundTrip.end());
+    std::cout << "[query] " << count << " requests, round trip p50 "
+              << roundTrip[roundTrip.size()/2] * 1e6 << " us, p99 "
+              << roundTrip[static_cast<std::size_t>(0.99*(roundTrip.size()-1) + 0.5)] * 1e6
+              << " us; result norm " << result.norm() << "\n";
+    if (args.has("output"))
+        saveSnapshotMatrix(args.require("output"), result);
+    return 0;
+}
+
+int runAll(const StageArgs& args) {
+    ScopedTimer timer("run", true);
+    // 1. Read configuration (by default ../config.txt, i.e. the parent
+    // directory of the build folder).
+    Config cfg = loadConfig(args);
+
+    std::cout << "[pipeline] Loaded configuration:\n";
+    std::cout << "  Grid: " << cfg.Nx << " x " << cfg.Ny << ", Domain: "
+              << cfg.Lx << " x " << cfg.Ly << "\n";
+    std::cout << "  Time: dt = " << cfg.dt << ", finalTime = " << cfg.finalTime << "\n";
+    std::cout << "  Viscosity: " << cfg.viscosity << "\n";
+    std::cout << "  Snapshot Interval: " << cfg.snapshotInterval << "\n";
+    std::cout << "  Snapshot File: " << cfg.snapshotFile << "\n";
+    std::cout << "  Number of POD Modes: " << cfg.numPodModes << "\n";
+
+    // 2. Run the full offline solver (simulate PDE and save snapshots).
+    std::cout << "[pipeline] Running offline PDE solver...\n";
+    auto telemetry = openTelemetry(cfg);
+    OfflineSolver2D offline(cfg);
+    offline.setTelemetry(telemetry.get(), cfg.telemetryInterval);
+    offline.runOfflineSolve();
+    std::cout << "[pipeline] Offline PDE solve completed.\n";
+
+    // 3. Load the snapshot matrix generated by the offline solver.
+    Eigen::MatrixXd X = loadSnapshotMatrix(cfg.snapshotFile);
+    std::cout << "[pipeline] Loaded snapshot matrix with dimensions: "
+              << X.rows() << " x " << X.cols() << "\n";
+
+    // 4. Compute the POD basis from the snapshot matrix.
+    // "tsqr" streams the snapshot file instead of using X.
+    POD pod = makePOD(cfg);
+    if (cfg.podMethod == "tsqr")
+        pod.computeBasisOutOfCore(cfg.snapshotFile, cfg.snapshotFile + ".basis",
+                                  cfg.podBlockRows);
+    else
+        pod.computeBasis(X);
+    bool assembled = (cfg.romOperators == "assembled");
+    pod.printTruncationReport(std::cout, [&](int k) {
+        return GalerkinROM::estimateFlopsPerStep(cfg.Nx, cfg.Ny, k, assembled);
+    });
+    std::cout << "[pipeline] POD basis computed with " << pod.numModes() << " modes.\n";
+
+    // 5. Build the Galerkin ROM using the POD basis.
+    // (operator inference and DMD learn their own operators instead)
+    const bool galerkin = (cfg.romType == "galerkin");
+    GalerkinROM gal = makeGalerkin(cfg, pod);
+    if (assembled && galerkin)
+        gal.assembleReducedOperators(!cfg.errorIndicatorFile.empty());
+    if (galerkin)
+        std::cout << "[pipeline] Galerkin ROM constructed ("
+                  << cfg.romOperators << " operators).\n";
+
+    // 6. Select an initial condition for the online (reduced) simulation.
+    // Here, we take the first column from the snapshot matrix.
+    Eigen::VectorXd x0 = X.col(0);
+    std::cout << "[pipeline] Initial condition loaded from snapshot.\n";
+
+    // 7. Run the online reduced-order simulation, either with the global
+    // basis, with localized (clustered) bases, or as a ROM/full-order hybrid.
+    Eigen::VectorXd xFinalROM;
+    if (cfg.hybridThreshold > 0.0) {
+        HybridSolver2D hybrid(cfg, pod, gal);
+        xFinalROM = hybrid.run(x0);
+    } else if (cfg.localClusters > 0) {
+        LocalGalerkinROM local(cfg, cfg.localClusters);
+        local.train(X);
+        OnlineSolver2D online(cfg, local);
+        xFinalROM = online.runReducedSolve(x0);
+        std::cout << "[pipeline] Localized ROM made " << online.basisSwitches()
+                  << " basis switches.\n";
+    } else if (!galerkin) {
+        // Any other registered model; those with reduced dynamics run
+        // through OnlineSolver2D so that outputs and telemetry still apply
+        auto model = ModelRegistry::create(cfg.romType, cfg);
+        model->train(pod, X);
+        if (auto* dyn = dynamic_cast<ReducedDynamics*>(model.get())) {
+            OnlineSolver2D online(cfg, *dyn);
+            attachOutputs(cfg, online);
+            online.setTelemetry(telemetry.get(), cfg.telemetryInterval);
+            if (!cfg.trajectoryErrorFile.empty())
+                online.recordReducedStates(cfg.snapshotInterval);
+            xFinalROM = online.runReducedSolve(x0);
+            writeOutputs(cfg, online);
+            reportTrajectoryErrors(cfg, online, dyn->pod().basis(), X, offline.snapshotTimes());
+        } else {
+            xFinalROM = model->predict(x0);
+        }
+    } else {
+        OnlineSolver2D online(cfg, gal);
+        attachOutputs(cfg, online);
+        online.setTelemetry(telemetry.get(), cfg.telemetryInterval);
+        if (!cfg.trajectoryErrorFile.empty())
+            online.recordReducedStates(cfg.snapshotInterval);
+        xFinalROM = online.runReducedSolve(x0);
+        reportErrorIndicator(cfg, online);
+        writeOutputs(cfg, online);
+        reportTrajectoryErrors(cfg, online, pod.basis(), X, offline.snapshotTimes());
+    }
+    std::cout << "[pipeline] Online reduced simulation completed.\n";
+    closeTelemetry(cfg, telemetry.get());
+
+    // 8. For comparison, get the final offline snapshot (last column).
+    Eigen::VectorXd xFinalOffline = X.col(X.cols() - 1);
+
+    // 9. Compute the error between the offline and ROM solutions.
+    double errorNorm = (xFinalOffline - xFinalROM).norm();
+    double refNorm = xFinalOffline.norm();
+    double relativeError = errorNorm / (refNorm + 1e-14);
+
+    std::cout << "[pipeline] Offline final solution norm: " << refNorm << "\n";
+    std::cout << "[pipeline] ROM final solution norm: " << xFinalROM.norm() << "\n";
+    std::cout << "[pipeline] Relative error: " << relativeError << "\n";
+    return 0;
+}
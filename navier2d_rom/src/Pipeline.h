@@ -0,0 +1,53 @@
+#pragma once
+#include <map>
+#include <string>
+
+// Options of a pipeline stage: "--key value" pairs and bare "--flag"s
+// following the subcommand on the command line.
+struct StageArgs
+{
+    std::map<std::string, std::string> values;
+
+    static StageArgs parse(int argc, char** argv, int first);
+
+    bool has(const std::string& key) const;
+    std::string get(const std::string& key, const std::string& fallback = "") const;
+    // Like get, but throws if the option is missing
+    std::string require(const std::string& key) const;
+};
+
+// Staged pipeline. Every stage reads and writes explicit artifact files and
+// leaves a "<output>.stamp" fingerprint of its inputs next to its output;
+// when the fingerprint still matches, the stage is skipped (--force reruns).
+//
+//   simulate --config C --snapshots S                   full-order solve
+//   train    --config C --snapshots S --basis B [--operators O]
+//   predict  --config C --basis B [--operators O] [--initial X0] --output P
+//   evaluate --prediction P --snapshots S [--column j] [--output M]
+//   sweep    --spec SW [--config C]                      parameter sweep
+//   scale    --spec SC [--config C]                      FOM vs ROM scaling study
+//   greedy   --spec G [--config C]                       greedy basis training
+//   parareal --config C [--basis B [--operators O]] --output P [--reference]
+//            time-parallel full-order solve (ROM coarse propagator if B)
+//   serve    --config C --basis B [--operators O] --socket P [--batch-window-us W]
+//   query    --socket P [--config C] [--initial X0] [--final-time T]
+//            [--viscosity nu] [--reduced] [--count N] [--output R] [--shutdown]
+//   run      [--config C]                                all of the above in memory
+//
+// Text or binary artifacts are chosen by extension (".bin" = binary); C
+// defaults to ../config.txt and O to B + ".ops".
+//
+// train and predict use the model named by the config's romType (see
+// ModelRegistry). predict treats every column of X0 as a query; more than
+// one are advanced together with ReducedOrderModel::predictBatch.
+int runSimulate(const StageArgs& args);
+int runTrain(const StageArgs& args);
+int runPredict(const StageArgs& args);
+int runEvaluate(const StageArgs& args);
+int runSweep(const StageArgs& args);
+int runScale(const StageArgs& args);
+int runGreedy(const StageArgs& args);
+int runParareal(const StageArgs& args);
+int runServe(const StageArgs& args);
+int runQuery(const StageArgs& args);
+int runAll(const StageArgs& args);
@@ -0,0 +1,52 @@
+#pragma once
+#include <Eigen/Dense>
+#include "POD.h"
+
+// Reduced dynamics da/dt = f(a) in the coordinates of a POD basis: what
+// the online integrators (OnlineSolver2D) need from a reduced model.
+// Implemented by the intrusive GalerkinROM and the data-driven
+// OperatorInferenceROM.
+class ReducedDynamics {
+public:
+    virtual ~ReducedDynamics() {}
+
+    // Basis of the reduced coordinates (x = Phi a)
+    virtual const POD& pod() const = 0;
+
+    // da/dt for a given a(t)
+    virtual Eigen::VectorXd computeReducedRHS(const Eigen::VectorXd& a) = 0;
+
+    // Column b is computeReducedRHS(A.col(b)) for a batch of states (k x B);
+    // models override this to evaluate the batch as matrix products
+    virtual Eigen::MatrixXd computeReducedRHSBatch(const Eigen::MatrixXd& A) {
+        Eigen::MatrixXd R(A.rows(), A.cols());
+        for (Eigen::Index b = 0; b < A.cols(); b++)
+            R.col(b) = computeReducedRHS(A.col(b));
+        return R;
+    }
+
+    // Same into caller-owned storage: R receives the k x B result and work
+    // is scratch the model sizes on first use (e.g. the quadratic terms of
+    // the batch), so repeated calls on same-sized batches do not allocate
+    // in the models that override it. A may be any column block, such as
+    // a single reduced state stepped in place.
+    virtual void computeReducedRHSBatch(const Eigen::Ref<const Eigen::MatrixXd>& A, Eigen::MatrixXd& R,
+                                        Eigen::MatrixXd& /*work*/) {
+        R = computeReducedRHSBatch(Eigen::MatrixXd(A));
+    }
+
+    // a_{n+1} = a_n + dt * RHS (explicit Euler)
+    Eigen::VectorXd stepExplicitEuler(const Eigen::VectorXd& a, double dt) {
+        return a + dt*computeReducedRHS(a);
+    }
+
+    // steps explicit Euler steps of a whole batch, in place; the RHS and
+    // the model's workspace are allocated once for all steps
+    void integrateBatch(Eigen::MatrixXd& A, double dt, int steps) {
+        Eigen::MatrixXd R(A.rows(), A.cols()), work;
+        for (int s = 0; s < steps; s++) {
+            computeReducedRHSBatch(A, R, work);
+            A.noalias() += dt*R;
+        }
+    }
+};
@@ -0,0 +1,108 @@
+#include "ReducedFunctionals.h"
+#include <stdexcept>
+
+ReducedFunctionals::ReducedFunctionals(const Eigen::MatrixXd& basis, int Nx, int Ny,
+                                       double dx, double dy, BoundaryCondition bc)
+    : basis_(basis), Nx_(Nx), Ny_(Ny), dx_(dx), dy_(dy),
+      periodic_(bc == BoundaryCondition::Periodic)
+{
+    if (basis_.rows() != 2*Nx_*Ny_)
+        throw std::runtime_error("Basis does not match the grid");
+    if (Nx_ < 3 || Ny_ < 3)
+        throw std::runtime_error("Functionals need at least 3 x 3 grid points");
+
+    const double dA = dx_*dy_;
+    addMap("energy", true, [](const Eigen::MatrixXd& X) { return X; }, 0.5*dA);
+    addMap("enstrophy", true, [this](const Eigen::MatrixXd& X) { return curl(X); }, 0.5*dA);
+
+    addMap("meanVorticity", false, [this](const Eigen::MatrixXd& X) { return curl(X); },
+           1.0/curlNodes());
+
+    Eigen::VectorXd flux = Eigen::VectorXd::Zero(2*Nx_*Ny_);
+    // Lx = Nx dx when periodic, (Nx-1) dx otherwise
+    const int iMid = (periodic_ ? Nx_ : Nx_ - 1) / 2;
+    for (int j = 0; j < Ny_; j++)
+        flux(iMid + j*Nx_) = dy_;
+    addLinear("fluxX", flux);
+}
+
+void ReducedFunctionals::addLinear(const std::string& name, const Eigen::VectorXd& weights) {
+    if (weights.size() != basis_.rows())
+        throw std::runtime_error("Functional " + name + " does not match the grid");
+    addMap(name, false,
+           [weights](const Eigen::MatrixXd& X) -> Eigen::MatrixXd { return weights.transpose() * X; },
+           1.0);
+}
+
+void ReducedFunctionals::addQuadratic(const std::string& name, const Eigen::MatrixXd& B) {
+    if (B.cols() != basis_.rows())
+        throw std::runtime_error("Functional " + name + " does not match the grid");
+    addMap(name, true, [B](const Eigen::MatrixXd& X) -> Eigen::MatrixXd { return B * X; }, 1.0);
+}
+
+void ReducedFunctionals::addMap(const std::string& name, bool quadratic, FieldMap map,
+                                double scale) {
+    Entry e;
+    e.name = name;
+    e.quadratic = quadratic;
+    e.scale = scale;
+    // One pass of the map over the basis: l = scale * 1^T (map Phi), or
+    // Q = scale * (map Phi)^T (map Phi), an O(m k^2) Gram
+    Eigen::MatrixXd mapped = map(basis_);
+    if (quadratic)
+        e.Q = scale * (mapped.transpose() * mapped);
+    else
+        e.l = scale * mapped.colwise().sum().transpose();
+    e.map = std::move(map);
+    entries_.push_back(std::move(e));
+}
+
+std::vector<std::string> ReducedFunctionals::names() const {
+    std::vector<std::string> out;
+    for (const auto& e : entries_)
+        out.push_back(e.name);
+    return out;
+}
+
+Eigen::VectorXd ReducedFunctionals::evaluate(const Eigen::VectorXd& a) const {
+    Eigen::VectorXd f(entries_.size());
+    for (std::size_t i = 0; i < entries_.size(); i++) {
+        const Entry& e = entries_[i];
+        f(i) = e.quadratic ? a.dot(e.Q * a) : e.l.dot(a);
+    }
+    return f;
+}
+
+Eigen::VectorXd ReducedFunctionals::evaluateFull(const Eigen::VectorXd& x) const {
+    Eigen::VectorXd f(entries_.size());
+    for (std::size_t i = 0; i < entries_.size(); i++) {
+        const Entry& e = entries_[i];
+        Eigen::MatrixXd mapped = e.map(x);
+        f(i) = e.scale * (e.quadratic ? mapped.squaredNorm() : mapped.sum());
+    }
+    return f;
+}
+
+int ReducedFunctionals::curlNodes() const {
+    return periodic_ ? Nx_*Ny_ : (Nx_-2)*(Ny_-2);
+}
+
+Eigen::MatrixXd ReducedFunctionals::curl(const Eigen::MatrixXd& X) const {
+    const int off = Nx_*Ny_;
+    const int lo = periodic_ ? 0 : 1;
+    Eigen::MatrixXd W(curlNodes(), X.cols());
+    for (Eigen::Index c = 0; c < X.cols(); c++) {
+        int r = 0;
+        for (int j = lo; j < Ny_-lo; j++) {
+            // Neighbour rows and columns, wrapped when periodic
+            const int jm = (j - 1 + Ny_) % Ny_, jp = (j + 1) % Ny_;
+            for (int i = lo; i < Nx_-lo; i++) {
+                const int im = (i - 1 + Nx_) % Nx_, ip = (i + 1) % Nx_;
+                double dvdx = (X(ip + j*Nx_ + off, c) - X(im + j*Nx_ + off, c)) / (2*dx_);
+                double dudy = (X(i + jp*Nx_, c)       - X(i + jm*Nx_, c))       / (2*dy_);
+                W(r++, c) = dvdx - dudy;
+            }
+        }
+    }
+    return W;
+}
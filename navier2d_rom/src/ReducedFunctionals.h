@@ -0,0 +1,70 @@
+#pragma once
+#include <Eigen/Dense>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Field2D.h"
+
+// Scalar output functionals of the velocity field x = Phi a, evaluated
+// directly from reduced coordinates. Every functional is either linear,
+// f(a) = l^T a, or quadratic, f(a) = a^T Q a, with l (k) and Q (k x k)
+// projected once from the full grid, so a diagnostic costs O(k^2) per step
+// instead of an O(nk) reconstruction.
+//
+// Built in (cell area dA = dx dy, vorticity w = dv/dx - du/dy by central
+// differences, as in the Galerkin residual: on the interior nodes, or on
+// every node with wrapped neighbours when periodic):
+//   energy         0.5 sum (u^2 + v^2) dA   Q = 0.5 dA Phi^T Phi
+//   enstrophy      0.5 sum w^2 dA           Q = 0.5 dA (W Phi)^T (W Phi)
+//   meanVorticity  mean of w over the nodes it is computed on
+//   fluxX          sum u dy along the grid column nearest x = Lx/2
+class ReducedFunctionals {
+public:
+    ReducedFunctionals(const Eigen::MatrixXd& basis, int Nx, int Ny, double dx, double dy,
+                       BoundaryCondition bc = BoundaryCondition::Dirichlet);
+    // The built-in maps refer back to this object
+    ReducedFunctionals(const ReducedFunctionals&) = delete;
+    ReducedFunctionals& operator=(const ReducedFunctionals&) = delete;
+
+    // f(x) = weights^T x for full-space weights (size n)
+    void addLinear(const std::string& name, const Eigen::VectorXd& weights);
+    // f(x) = ||B x||^2 for a full-space map B (m x n)
+    void addQuadratic(const std::string& name, const Eigen::MatrixXd& B);
+
+    int size() const { return static_cast<int>(entries_.size()); }
+    std::vector<std::string> names() const;
+
+    // All functionals for one reduced state, in names() order
+    Eigen::VectorXd evaluate(const Eigen::VectorXd& a) const;
+
+    // The same functionals from a full state, O(n) each; for validation
+    Eigen::VectorXd evaluateFull(const Eigen::VectorXd& x) const;
+
+private:
+    // Full-space map applied column-wise (n x c -> m x c)
+    using FieldMap = std::function<Eigen::MatrixXd(const Eigen::MatrixXd&)>;
+
+    // Linear:    f(x) = scale * sum(map(x))
+    // Quadratic: f(x) = scale * ||map(x)||^2
+    struct Entry {
+        std::string name;
+        bool quadratic;
+        FieldMap map;
+        double scale;
+        Eigen::VectorXd l;        // reduced linear form (k)
+        Eigen::MatrixXd Q;        // reduced quadratic form (k x k)
+    };
+
+    const Eigen::MatrixXd& basis_;
+    int Nx_, Ny_;
+    double dx_, dy_;
+    bool periodic_;
+    std::vector<Entry> entries_;
+
+    void addMap(const std::string& name, bool quadratic, FieldMap map, double scale);
+
+    // Vorticity of each column of X (2 Nx Ny x c -> m x c), m = Nx Ny when
+    // periodic and (Nx-2)(Ny-2) interior nodes otherwise
+    int curlNodes() const;
+    Eigen::MatrixXd curl(const Eigen::MatrixXd& X) const;
+};
@@ -1,7 +1,10 @@
 #pragma once
 #include <Eigen/Dense>
+#include <stdexcept>
 #include <string>
 
+class POD;
+
 class ReducedOrderModel {
 public:
     virtual ~ReducedOrderModel() {}
@@ -9,9 +12,33 @@ public:
     // Train on snapshot matrix X
     virtual void train(const Eigen::MatrixXd& X) = 0;
 
+    // Same, reusing a POD basis already computed from X where the model
+    // has one (the default ignores it)
+    virtual void train(const POD& /*pod*/, const Eigen::MatrixXd& X) { train(X); }
+
     // Predict or reconstruct from an initial condition
     virtual Eigen::VectorXd predict(const Eigen::VectorXd& initialState) = 0;
 
+    // Batched predict: column j of out (n x B, sized by the caller) receives
+    // predict(X0.col(j)). Models override this to project, advance and
+    // reconstruct the whole batch as matrix products; the default loops.
+    virtual void predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X0,
+                              Eigen::Ref<Eigen::MatrixXd> out) {
+        if (out.rows() != X0.rows() || out.cols() != X0.cols())
+            throw std::runtime_error("predictBatch: output must match the input size");
+        for (Eigen::Index j = 0; j < X0.cols(); j++)
+            out.col(j) = predict(X0.col(j));
+    }
+
     // For reporting or saving results
-    virtual void saveResults(const std::string& filename) {}
+    virtual void saveResults(const std::string& /*filename*/) {}
+
+    // Serialization of a trained model: the basis (binary snapshot format)
+    // and the model's own operators (binary), as written by the train stage
+    virtual void save(const std::string& /*basisFile*/, const std::string& /*operatorFile*/) const {
+        throw std::runtime_error("This reduced model cannot be saved");
+    }
+    virtual void load(const std::string& /*basisFile*/, const std::string& /*operatorFile*/) {
+        throw std::runtime_error("This reduced model cannot be loaded");
+    }
 };
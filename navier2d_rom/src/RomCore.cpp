@@ -0,0 +1,127 @@
+#include "navier2d_rom/RomCore.h"
+#include <cmath>
+#include <stdexcept>
+#include "Config.h"
+#include "DMDROM.h"
+#include "GalerkinModel.h"
+#include "ModelRegistry.h"
+#include "OutputProbes.h"
+#include "POD.h"
+#include "ReducedDynamics.h"
+
+struct RomCore::Impl
+{
+    Config cfg;
+    std::unique_ptr<ReducedOrderModel> model;
+    ReducedDynamics* dyn = nullptr;  // stepped models
+    DMDROM* dmd = nullptr;           // closed-form model
+    const POD* pod = nullptr;
+    double dt = 0.0;
+    std::unique_ptr<OutputProbes> probes;
+    // step() workspace (RHS and model scratch), kept across calls
+    Eigen::MatrixXd rhs, work;
+};
+
+static void checkSize(Eigen::Index got, Eigen::Index want, const char* what) {
+    if (got != want)
+        throw std::runtime_error(std::string("RomCore: ") + what + " has size "
+                                 + std::to_string(got) + ", expected " + std::to_string(want));
+}
+
+RomCore::RomCore(const std::string& configFile, const std::string& basisFile,
+                 const std::string& operatorFile)
+    : impl_(new Impl)
+{
+    Impl& m = *impl_;
+    m.cfg = Config::fromTXT(configFile);
+    m.dt = m.cfg.dt;
+    m.model = ModelRegistry::create(m.cfg.romType, m.cfg);
+    m.model->load(basisFile, operatorFile.empty() ? basisFile + ".ops" : operatorFile);
+
+    if (auto* gm = dynamic_cast<GalerkinModel*>(m.model.get()))
+        m.dyn = &gm->rom();
+    else
+        m.dyn = dynamic_cast<ReducedDynamics*>(m.model.get());
+    m.dmd = dynamic_cast<DMDROM*>(m.model.get());
+    if (m.dyn)
+        m.pod = &m.dyn->pod();
+    else if (m.dmd)
+        m.pod = &m.dmd->pod();
+    else
+        throw std::runtime_error("RomCore: model " + m.cfg.romType + " has no reduced coordinates");
+}
+
+RomCore::~RomCore() = default;
+RomCore::RomCore(RomCore&&) noexcept = default;
+RomCore& RomCore::operator=(RomCore&&) noexcept = default;
+
+const std::string& RomCore::modelName() const { return impl_->cfg.romType; }
+Eigen::Index RomCore::stateSize() const { return impl_->pod->basis().rows(); }
+int RomCore::numModes() const { return impl_->pod->numModes(); }
+double RomCore::timeStep() const { return impl_->dt; }
+
+void RomCore::setTimeStep(double dt) {
+    if (!(dt > 0.0))
+        throw std::runtime_error("RomCore: time step must be positive");
+    impl_->dt = dt;
+}
+
+void RomCore::reduce(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::Ref<Eigen::VectorXd> a) const {
+    checkSize(x.size(), stateSize(), "state");
+    checkSize(a.size(), numModes(), "reduced state");
+    a.noalias() = impl_->pod->basis().transpose() * x;
+}
+
+void RomCore::step(Eigen::Ref<Eigen::VectorXd> a, int steps) {
+    checkSize(a.size(), numModes(), "reduced state");
+    Impl& m = *impl_;
+    if (m.dmd) {
+        a = m.dmd->advanceReduced(a, steps*m.dt);
+        return;
+    }
+    for (int i = 0; i < steps; i++) {
+        m.dyn->computeReducedRHSBatch(a, m.rhs, m.work);
+        a.noalias() += m.dt*m.rhs.col(0);
+    }
+}
+
+void RomCore::advance(Eigen::Ref<Eigen::VectorXd> a, double t) {
+    checkSize(a.size(), numModes(), "reduced state");
+    if (impl_->dmd)
+        a = impl_->dmd->advanceReduced(a, t);
+    else
+        step(a, static_cast<int>(std::ceil(t/impl_->dt)));
+}
+
+void RomCore::reconstruct(const Eigen::Ref<const Eigen::VectorXd>& a, Eigen::Ref<Eigen::VectorXd> x) const {
+    checkSize(a.size(), numModes(), "reduced state");
+    checkSize(x.size(), stateSize(), "state");
+    x.noalias() = impl_->pod->basis() * a;
+}
+
+void RomCore::predict(const Eigen::Ref<const Eigen::MatrixXd>& X0, Eigen::Ref<Eigen::MatrixXd> out) {
+    checkSize(X0.rows(), stateSize(), "initial state");
+    impl_->model->predictBatch(X0, out);
+}
+
+void RomCore::setProbes(const std::vector<std::array<double, 2>>& points) {
+    const Config& cfg = impl_->cfg;
+    std::vector<Eigen::Vector2d> pts;
+    for (const auto& p : points)
+        pts.emplace_back(p[0], p[1]);
+    impl_->probes = std::make_unique<OutputProbes>(impl_->pod->basis(), cfg.Nx, cfg.Ny,
+                                                   cfg.dx(), cfg.dy(), pts,
+                                                   boundaryFromString(cfg.boundary));
+}
+
+int RomCore::numProbes() const {
+    return impl_->probes ? impl_->probes->numPoints() : 0;
+}
+
+void RomCore::probe(const Eigen::Ref<const Eigen::VectorXd>& a, Eigen::Ref<Eigen::VectorXd> values) const {
+    if (!impl_->probes)
+        throw std::runtime_error("RomCore: no probes set");
+    checkSize(a.size(), numModes(), "reduced state");
+    checkSize(values.size(), 2*numProbes(), "probe output");
+    values.noalias() = impl_->probes->rows() * a;
+}
@@ -0,0 +1,454 @@
+#include "RomServer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static volatile std::sig_atomic_t g_stopServer = 0;
+
+static void onStopSignal(int) {
+    g_stopServer = 1;
+}
+
+static std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool readAll(int fd, void* buf, std::size_t bytes) {
+    char* p = static_cast<char*>(buf);
+    while (bytes > 0) {
+        ssize_t r = ::recv(fd, p, bytes, 0);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return false;
+        p += r;
+        bytes -= r;
+    }
+    return true;
+}
+
+static bool writeAll(int fd, const void* buf, std::size_t bytes) {
+    const char* p = static_cast<const char*>(buf);
+    while (bytes > 0) {
+        ssize_t w = ::send(fd, p, bytes, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR)
+            continue;
+        if (w <= 0)
+            return false;
+        p += w;
+        bytes -= w;
+    }
+    return true;
+}
+
+static bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        throw std::runtime_error("Socket path too long: " + path);
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return addr;
+}
+
+// ---------------------------------------------------------------------------
+// Server
+
+RomServer::RomServer(const Config& cfg, GalerkinROM& rom, const std::string& socketPath,
+                     int batchWindowUs)
+    : cfg_(cfg), rom_(rom), socketPath_(socketPath), batchWindowUs_(batchWindowUs)
+{
+    sockaddr_un addr = socketAddress(socketPath_);
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0)
+        throw std::runtime_error("Cannot create socket");
+    ::unlink(socketPath_.c_str());
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listenFd_, 64) < 0 || !setNonBlocking(listenFd_)) {
+        ::close(listenFd_);
+        throw std::runtime_error("Cannot listen on " + socketPath_ + ": " + std::strerror(errno));
+    }
+}
+
+RomServer::~RomServer() {
+    for (int fd : clients_)
+        ::close(fd);
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(socketPath_.c_str());
+    }
+}
+
+void RomServer::acceptClients() {
+    for (;;) {
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0)
+            return;
+        if (!setNonBlocking(fd)) {
+            ::close(fd);
+            continue;
+        }
+        clients_.push_back(fd);
+    }
+}
+
+void RomServer::closeClient(int fd) {
+    ::close(fd);
+    clients_.erase(std::remove(clients_.begin(), clients_.end(), fd), clients_.end());
+    inbox_.erase(fd);
+    outbox_.erase(fd);
+}
+
+// Append whatever a readable client has sent to its inbox without
+// blocking. Returns false if the client disconnected (it is then closed).
+bool RomServer::receive(int fd) {
+    std::vector<char>& inbox = inbox_[fd];
+    char buf[65536];
+    for (;;) {
+        ssize_t r = ::recv(fd, buf, sizeof(buf), 0);
+        if (r > 0) {
+            inbox.insert(inbox.end(), buf, buf + r);
+            continue;
+        }
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        closeClient(fd);
+        return false;
+    }
+}
+
+// Move one complete request from the client's inbox to the batch. Returns
+// false if none is complete yet, or if the client sent garbage (it is then
+// closed); a partial request stays buffered until the rest arrives.
+bool RomServer::takeRequest(int fd, std::vector<Pending>& batch, bool& shutdown) {
+    auto it = inbox_.find(fd);
+    if (it == inbox_.end() || it->second.size() < sizeof(RomRequestHeader))
+        return false;
+    std::vector<char>& inbox = it->second;
+
+    Pending p;
+    p.fd = fd;
+    std::memcpy(&p.header, inbox.data(), sizeof(p.header));
+    // Cap the payload at a full state so a bad length cannot exhaust memory
+    const bool stop = p.header.flags & kRomShutdown;
+    if (p.header.magic != kRomRequestMagic ||
+        (!stop && p.header.length > static_cast<std::uint64_t>(rom_.pod().basis().rows()))) {
+        closeClient(fd);
+        return false;
+    }
+    const std::size_t payload = stop ? 0 : p.header.length*sizeof(double);
+    if (inbox.size() < sizeof(p.header) + payload)
+        return false;
+
+    p.state.resize(stop ? 0 : p.header.length);
+    std::memcpy(p.state.data(), inbox.data() + sizeof(p.header), payload);
+    inbox.erase(inbox.begin(), inbox.begin() + sizeof(p.header) + payload);
+    p.receivedNs = nowNs();
+    if (stop) {
+        shutdown = true;
+        reply(p, 0, Eigen::VectorXd());
+        return true;
+    }
+    batch.push_back(std::move(p));
+    return true;
+}
+
+// Queue the reply behind anything still unsent to that client and send
+// what the socket takes now; the rest goes out when poll reports the
+// socket writable, so a client that stops reading only delays itself.
+void RomServer::reply(const Pending& p, std::uint32_t status, const Eigen::VectorXd& out) {
+    RomReplyHeader h{};
+    h.magic = kRomReplyMagic;
+    h.status = status;
+    h.length = status == 0 ? out.size() : 0;
+    double secs = (nowNs() - p.receivedNs) * 1e-9;
+    h.serverSeconds = secs;
+    if (!(p.header.flags & kRomShutdown))
+        latencies_.push_back(secs);
+    // The client may have hung up while its request was in the batch
+    if (std::find(clients_.begin(), clients_.end(), p.fd) == clients_.end())
+        return;
+
+    std::vector<char>& outbox = outbox_[p.fd];
+    const char* hp = reinterpret_cast<const char*>(&h);
+    const char* dp = reinterpret_cast<const char*>(out.data());
+    outbox.insert(outbox.end(), hp, hp + sizeof(h));
+    outbox.insert(outbox.end(), dp, dp + h.length*sizeof(double));
+    flush(p.fd);
+}
+
+// Send as much of the client's outbox as its socket accepts without
+// blocking. Returns false if the client is gone (it is then closed).
+bool RomServer::flush(int fd) {
+    auto it = outbox_.find(fd);
+    if (it == outbox_.end())
+        return true;
+    std::vector<char>& outbox = it->second;
+    std::size_t sent = 0;
+    while (sent < outbox.size()) {
+        ssize_t w = ::send(fd, outbox.data() + sent, outbox.size() - sent, MSG_NOSIGNAL);
+        if (w > 0) {
+            sent += w;
+            continue;
+        }
+        if (w < 0 && errno == EINTR)
+            continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        closeClient(fd);
+        return false;
+    }
+    if (sent == outbox.size())
+        outbox_.erase(it);
+    else
+        outbox.erase(outbox.begin(), outbox.begin() + sent);
+    return true;
+}
+
+void RomServer::solveBatch(std::vector<Pending>& batch) {
+    if (batch.empty())
+        return;
+    batches_++;
+    const Eigen::MatrixXd& Phi = rom_.pod().basis();
+    const Eigen::Index n = Phi.rows(), k = Phi.cols();
+
+    // Group by (finalTime, viscosity); each group advances as one k x B block.
+    std::map<std::pair<double, double>, std::vector<std::size_t>> groups;
+    for (std::size_t r = 0; r < batch.size(); r++) {
+        const auto& h = batch[r].header;
+        double T  = h.finalTime > 0.0 ? h.finalTime : cfg_.finalTime;
+        double nu = h.viscosity > 0.0 ? h.viscosity : cfg_.viscosity;
+        bool reduced = h.flags & kRomReducedInput;
+        if (batch[r].state.size() != (reduced ? k : n)) {
+            reply(batch[r], 1, Eigen::VectorXd());
+            continue;
+        }
+        groups[{T, nu}].push_back(r);
+    }
+
+    for (const auto& g : groups) {
+        const std::vector<std::size_t>& ids = g.second;
+        const int B = ids.size();
+
+        // Project all full-state inputs with one GEMM
+        std::vector<std::size_t> fullIn;
+        for (std::size_t id : ids)
+            if (!(batch[id].header.flags & kRomReducedInput))
+                fullIn.push_back(id);
+        Eigen::MatrixXd X0(n, fullIn.size());
+        for (std::size_t c = 0; c < fullIn.size(); c++)
+            X0.col(c) = batch[fullIn[c]].state;
+        Eigen::MatrixXd A0 = Phi.transpose() * X0;
+
+        Eigen::MatrixXd A(k, B);
+        for (int b = 0, f = 0; b < B; b++) {
+            const Pending& p = batch[ids[b]];
+            A.col(b) = (p.header.flags & kRomReducedInput) ? Eigen::VectorXd(p.state)
+                                                           : Eigen::VectorXd(A0.col(f++));
+        }
+
+        rom_.setViscosity(g.first.second);
+        int steps = static_cast<int>(std::ceil(g.first.first/cfg_.dt));
+        rom_.integrateBatch(A, cfg_.dt, steps);
+
+        // Reconstruct all full-state outputs with one GEMM
+        std::vector<int> fullOut;
+        for (int b = 0; b < B; b++)
+            if (batch[ids[b]].header.flags & kRomFullOutput)
+                fullOut.push_back(b);
+        Eigen::MatrixXd Asel(k, fullOut.size());
+        for (std::size_t c = 0; c < fullOut.size(); c++)
+            Asel.col(c) = A.col(fullOut[c]);
+        Eigen::MatrixXd Xout = Phi * Asel;
+
+        for (int b = 0, f = 0; b < B; b++) {
+            const Pending& p = batch[ids[b]];
+            if (p.header.flags & kRomFullOutput)
+                reply(p, 0, Xout.col(f++));
+            else
+                reply(p, 0, A.col(b));
+        }
+    }
+    rom_.setViscosity(cfg_.viscosity);
+}
+
+void RomServer::run(int reportEvery) {
+    struct sigaction sa{};
+    sa.sa_handler = onStopSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    g_stopServer = 0;
+
+    std::cout << "[RomServer] Listening on " << socketPath_ << " (k="
+              << rom_.pod().numModes() << ")" << std::endl;
+
+    bool shutdown = false;
+    std::size_t lastReport = 0;
+    while (!g_stopServer && !shutdown) {
+        std::vector<Pending> batch;
+        std::int64_t deadline = 0;
+
+        // Requests already buffered behind ones answered in earlier batches
+        // (not from a client that has yet to take its last reply)
+        for (int fd : std::vector<int>(clients_))
+            if (!outbox_.count(fd))
+                takeRequest(fd, batch, shutdown);
+        if (!batch.empty())
+            deadline = nowNs() + static_cast<std::int64_t>(batchWindowUs_) * 1000;
+
+        // Gather every request that is ready; with a batch window, keep
+        // polling until it closes after the first request arrived.
+        while (!shutdown && !(batchWindowUs_ <= 0 && !batch.empty())) {
+            std::vector<pollfd> fds;
+            fds.push_back({listenFd_, POLLIN, 0});
+            for (int fd : clients_) {
+                // One request per client per batch; later ones wait their
+                // turn, and a client with unsent replies is not read until
+                // it takes them, which bounds its outbox
+                bool pending = std::any_of(batch.begin(), batch.end(),
+                                           [fd](const Pending& p) { return p.fd == fd; });
+                bool unsent = outbox_.count(fd) > 0;
+                short events = (unsent ? POLLOUT : 0) | (pending || unsent ? 0 : POLLIN);
+                if (events)
+                    fds.push_back({fd, events, 0});
+            }
+
+            int timeoutMs = -1;
+            if (!batch.empty()) {
+                std::int64_t left = deadline - nowNs();
+                if (left <= 0)
+                    break;
+                timeoutMs = static_cast<int>((left + 999999) / 1000000);
+            }
+            int ready = ::poll(fds.data(), fds.size(), timeoutMs);
+            if (ready < 0 && errno == EINTR) {
+                if (g_stopServer)
+                    break;
+                continue;
+            }
+            if (ready <= 0)
+                break;
+
+            if (fds[0].revents & POLLIN)
+                acceptClients();
+            for (std::size_t i = 1; i < fds.size(); i++) {
+                const int fd = fds[i].fd;
+                const short rev = fds[i].revents;
+                if ((rev & POLLOUT) && !flush(fd))
+                    continue;
+                if (fds[i].events & POLLIN) {
+                    if ((rev & (POLLIN | POLLHUP | POLLERR)) && !receive(fd))
+                        continue;
+                } else if (rev & (POLLHUP | POLLERR)) {
+                    // Gone before taking its replies
+                    closeClient(fd);
+                    continue;
+                }
+                // Only whole requests join the batch; a partial one waits in
+                // the client's inbox for the rest. A client that has just
+                // taken its last reply may have whole requests buffered.
+                bool pending = std::any_of(batch.begin(), batch.end(),
+                                           [fd](const Pending& p) { return p.fd == fd; });
+                if (pending || outbox_.count(fd))
+                    continue;
+                bool wasEmpty = batch.empty();
+                takeRequest(fd, batch, shutdown);
+                if (wasEmpty && !batch.empty())
+                    deadline = nowNs() + static_cast<std::int64_t>(batchWindowUs_) * 1000;
+            }
+        }
+
+        solveBatch(batch);
+        if (reportEvery > 0 && latencies_.size() - lastReport >= static_cast<std::size_t>(reportEvery)) {
+            printLatencyReport();
+            lastReport = latencies_.size();
+        }
+    }
+    // Last chance for queued replies (the shutdown acknowledgement)
+    for (int fd : std::vector<int>(clients_))
+        flush(fd);
+    printLatencyReport();
+}
+
+void RomServer::printLatencyReport() const {
+    if (latencies_.empty()) {
+        std::cout << "[RomServer] No requests served\n";
+        return;
+    }
+    std::vector<double> sorted = latencies_;
+    std::sort(sorted.begin(), sorted.end());
+    auto pct = [&](double q) {
+        std::size_t i = static_cast<std::size_t>(q * (sorted.size() - 1) + 0.5);
+        return sorted[i] * 1e6;
+    };
+    std::cout << "[RomServer] " << sorted.size() << " requests in " << batches_
+              << " batches: p50 " << pct(0.50) << " us, p99 " << pct(0.99)
+              << " us, max " << sorted.back() * 1e6 << " us" << std::endl;
+}
+
+// ---------------------------------------------------------------------------
+// Client
+
+RomClient::RomClient(const std::string& socketPath) {
+    sockaddr_un addr = socketAddress(socketPath);
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        if (fd_ >= 0)
+            ::close(fd_);
+        throw std::runtime_error("Cannot connect to " + socketPath + ": " + std::strerror(errno));
+    }
+}
+
+RomClient::~RomClient() {
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+std::uint32_t RomClient::solve(const Eigen::VectorXd& initial, std::uint32_t flags,
+                               double finalTime, double viscosity,
+                               Eigen::VectorXd& result, double* serverSeconds)
+{
+    RomRequestHeader h{};
+    h.magic = kRomRequestMagic;
+    h.flags = flags;
+    h.finalTime = finalTime;
+    h.viscosity = viscosity;
+    h.length = initial.size();
+    if (!writeAll(fd_, &h, sizeof(h)) ||
+        !writeAll(fd_, initial.data(), h.length*sizeof(double)))
+        throw std::runtime_error("RomClient: send failed");
+
+    RomReplyHeader r{};
+    if (!readAll(fd_, &r, sizeof(r)) || r.magic != kRomReplyMagic)
+        throw std::runtime_error("RomClient: bad reply");
+    result.resize(r.length);
+    if (!readAll(fd_, result.data(), r.length*sizeof(double)))
+        throw std::runtime_error("RomClient: truncated reply");
+    if (serverSeconds)
+        *serverSeconds = r.serverSeconds;
+    return r.status;
+}
+
+void RomClient::shutdownServer() {
+    Eigen::VectorXd empty, ignored;
+    solve(empty, kRomShutdown, 0.0, 0.0, ignored);
+}
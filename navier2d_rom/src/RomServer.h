@@ -0,0 +1,102 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "Config.h"
+#include "GalerkinROM.h"
+
+// Binary protocol over a local (AF_UNIX, SOCK_STREAM) socket, native byte
+// order. A request is a RomRequestHeader followed by `length` doubles (the
+// initial state, full n or reduced k values); the reply is a
+// RomReplyHeader followed by `length` doubles.
+enum RomRequestFlags : std::uint32_t {
+    kRomReducedInput  = 1u << 0,  // initial state given as reduced coordinates
+    kRomFullOutput    = 1u << 1,  // reply with the reconstructed full state
+    kRomShutdown      = 1u << 2   // stop the server (no payload, empty reply)
+};
+
+struct RomRequestHeader
+{
+    std::uint32_t magic;      // kRomRequestMagic
+    std::uint32_t flags;      // RomRequestFlags
+    double finalTime;         // <= 0: use the server config's finalTime
+    double viscosity;         // <= 0: use the server config's viscosity
+    std::uint64_t length;
+};
+
+struct RomReplyHeader
+{
+    std::uint32_t magic;      // kRomReplyMagic
+    std::uint32_t status;     // 0 = ok, otherwise the payload is empty
+    double serverSeconds;     // time from request receipt to reply
+    std::uint64_t length;
+};
+
+constexpr std::uint32_t kRomRequestMagic = 0x5144324E; // "N2DQ"
+constexpr std::uint32_t kRomReplyMagic   = 0x5244324E; // "N2DR"
+
+// Long-lived query server: holds the POD basis and assembled Galerkin
+// operators in memory and answers solve requests. Requests that are ready
+// together (optionally waiting batchWindowUs for more) are solved as one
+// batch per (finalTime, viscosity): one GEMM to project, the reduced
+// states advanced together, one GEMM to reconstruct. Sockets are
+// non-blocking and every client has its own input and output buffer, so a
+// client that sends slowly or stops reading holds up only itself.
+class RomServer {
+public:
+    RomServer(const Config& cfg, GalerkinROM& rom, const std::string& socketPath,
+              int batchWindowUs = 0);
+    ~RomServer();
+
+    // Serve until a shutdown request or SIGINT/SIGTERM; prints latency
+    // percentiles every reportEvery requests and on exit.
+    void run(int reportEvery = 1000);
+
+    void printLatencyReport() const;
+
+private:
+    struct Pending {
+        int fd;
+        RomRequestHeader header;
+        Eigen::VectorXd state;
+        std::int64_t receivedNs;
+    };
+
+    Config cfg_;
+    GalerkinROM& rom_;
+    std::string socketPath_;
+    int batchWindowUs_;
+    int listenFd_ = -1;
+    std::vector<int> clients_;                // non-blocking
+    std::map<int, std::vector<char>> inbox_;  // bytes received, not yet a whole request
+    std::map<int, std::vector<char>> outbox_; // reply bytes the socket has not taken yet
+    std::vector<double> latencies_;   // seconds, per request
+    std::size_t batches_ = 0;
+
+    void acceptClients();
+    bool receive(int fd);
+    bool takeRequest(int fd, std::vector<Pending>& batch, bool& shutdown);
+    void solveBatch(std::vector<Pending>& batch);
+    void reply(const Pending& p, std::uint32_t status, const Eigen::VectorXd& out);
+    bool flush(int fd);
+    void closeClient(int fd);
+};
+
+// Blocking client for RomServer
+class RomClient {
+public:
+    explicit RomClient(const std::string& socketPath);
+    ~RomClient();
+
+    // Send one request and wait for the reply payload; returns the status.
+    std::uint32_t solve(const Eigen::VectorXd& initial, std::uint32_t flags,
+                        double finalTime, double viscosity,
+                        Eigen::VectorXd& result, double* serverSeconds = nullptr);
+
+    void shutdownServer();
+
+private:
+    int fd_ = -1;
+};
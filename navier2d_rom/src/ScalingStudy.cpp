@@ -0,0 +1,215 @@
+#include "ScalingStudy.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "GalerkinROM.h"
+#include "Instrumentation.h"
+#include "OfflineSolver2D.h"
+#include "OnlineSolver2D.h"
+#include "POD.h"
+#include "Parallel.h"
+#include "Util.h"
+
+ScalingSpec ScalingSpec::fromTXT(const std::string& filename)
+{
+    std::ifstream ifs(filename);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Cannot open scaling spec: " + filename);
+    }
+
+    ScalingSpec spec;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(stripComment(line));
+        std::string key;
+        if (!(iss >> key))
+            continue;
+
+        auto readList = [&](std::vector<int>& values) {
+            values.clear();
+            int v;
+            while (iss >> v)
+                values.push_back(v);
+            if (values.empty())
+                throw std::runtime_error("Empty value list for " + key);
+        };
+
+        bool ok = true;
+        if (key == "grid")
+            readList(spec.grids);
+        else if (key == "modes")
+            readList(spec.modes);
+        else if (key == "threads")
+            readList(spec.threads);
+        else if (key == "finalTime")
+            ok = static_cast<bool>(iss >> spec.finalTime);
+        else if (key == "snapshots")
+            ok = static_cast<bool>(iss >> spec.snapshots);
+        else if (key == "csv")
+            ok = static_cast<bool>(iss >> spec.csvFile);
+        else if (key == "json")
+            ok = static_cast<bool>(iss >> spec.jsonFile);
+        else
+            throw std::runtime_error("Unknown scaling key: " + key);
+        if (!ok)
+            throw std::runtime_error("Error reading " + key);
+    }
+    if (spec.grids.empty() || spec.modes.empty())
+        throw std::runtime_error("Scaling spec needs grid and modes lists");
+    return spec;
+}
+
+ScalingStudy::ScalingStudy(const Config& base, const ScalingSpec& spec)
+    : base_(base), spec_(spec)
+{}
+
+Config ScalingStudy::caseConfig(int N) const {
+    Config cfg = base_;
+    cfg.Nx = cfg.Ny = N;
+    cfg.finalTime = spec_.finalTime;
+    double dx = std::min(cfg.dx(), cfg.dy());
+    double dtDiffusion = 0.2*dx*dx / cfg.viscosity;
+    double dtAdvection = 0.5*dx / std::max(std::abs(cfg.swirlAmplitude), 1e-12);
+    cfg.dt = std::min({base_.dt, dtDiffusion, dtAdvection});
+    int steps = static_cast<int>(std::ceil(cfg.finalTime/cfg.dt));
+    cfg.snapshotInterval = std::max(1, steps / std::max(1, spec_.snapshots));
+    return cfg;
+}
+
+void ScalingStudy::run() {
+    results_.clear();
+    const int savedThreads = numThreads();
+
+    for (int N : spec_.grids) {
+        Config cfg = caseConfig(N);
+        const int steps = static_cast<int>(std::ceil(cfg.finalTime/cfg.dt));
+        double dx = cfg.dx();
+        double dy = cfg.dy();
+
+        // The full-order solve is serial, so one run per grid serves every
+        // thread count
+        Eigen::MatrixXd X;
+        Eigen::VectorXd xFinal;
+        double offlineSeconds;
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            OfflineSolver2D offline(cfg);
+            offline.simulate();
+            offlineSeconds = secondsSince(t0);
+
+            const auto& snaps = offline.snapshots();
+            X.resize(snaps[0].size(), snaps.size());
+            for (std::size_t c = 0; c < snaps.size(); c++)
+                X.col(c) = snaps[c];
+            xFinal = offline.state();
+        }
+
+        for (int threads : spec_.threads) {
+            setNumThreads(threads);
+
+            for (int k : spec_.modes) {
+                if (k > X.cols()) {
+                    std::cerr << "[ScalingStudy] Skipping k=" << k << ": only "
+                              << X.cols() << " snapshots\n";
+                    continue;
+                }
+                Config kcfg = cfg;
+                kcfg.numPodModes = k;
+                Instrumentation::resetPeakRss();
+
+                auto t0 = std::chrono::steady_clock::now();
+                POD pod(k, POD::methodFromString(cfg.podMethod == "tsqr" ? "auto" : cfg.podMethod));
+                pod.setRandomizedOptions(cfg.podOversampling, cfg.podPowerIterations, cfg.podSeed);
+                pod.computeBasis(X);
+                double podSeconds = secondsSince(t0);
+
+                t0 = std::chrono::steady_clock::now();
+                GalerkinROM gal(pod, N, N, dx, dy, cfg.viscosity, boundaryFromString(cfg.boundary));
+                gal.assembleReducedOperators();
+                double assemblySeconds = secondsSince(t0);
+
+                t0 = std::chrono::steady_clock::now();
+                OnlineSolver2D online(kcfg, gal);
+                Eigen::VectorXd xRom = online.runReducedSolve(X.col(0));
+                double onlineSeconds = secondsSince(t0);
+
+                ScalingResult r;
+                r.N = N;
+                r.k = pod.numModes();
+                r.threads = numThreads();
+                r.dt = cfg.dt;
+                r.steps = steps;
+                r.offlineSeconds = offlineSeconds;
+                r.podSeconds = podSeconds;
+                r.assemblySeconds = assemblySeconds;
+                r.onlineSeconds = onlineSeconds;
+                r.offlineStepSeconds = offlineSeconds / steps;
+                r.onlineStepSeconds = onlineSeconds / steps;
+                r.speedup = offlineSeconds / onlineSeconds;
+                r.breakEvenQueries = (offlineSeconds + podSeconds + assemblySeconds)
+                                   / std::max(offlineSeconds - onlineSeconds, 1e-300);
+                r.relativeError = (xFinal - xRom).norm() / (xFinal.norm() + 1e-14);
+                r.peakRssKB = Instrumentation::peakRssKB();
+                results_.push_back(r);
+
+                std::cout << "[ScalingStudy] N=" << N << " k=" << r.k << " threads=" << r.threads
+                          << ": offline " << offlineSeconds << " s, POD " << podSeconds
+                          << " s, assembly " << assemblySeconds << " s, online "
+                          << r.onlineStepSeconds*1e6 << " us/step, speedup "
+                          << r.speedup << "x, error " << r.relativeError << "\n";
+            }
+        }
+    }
+    setNumThreads(savedThreads);
+
+    writeCSV(spec_.csvFile);
+    if (!spec_.jsonFile.empty())
+        writeJSON(spec_.jsonFile);
+    std::cout << "[ScalingStudy] Wrote " << results_.size() << " cases to " << spec_.csvFile
+              << (spec_.jsonFile.empty() ? "" : " and " + spec_.jsonFile) << "\n";
+}
+
+void ScalingStudy::writeCSV(const std::string& file) const {
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs.precision(8);
+    ofs << "N,k,threads,dt,steps,offlineSeconds,podSeconds,assemblySeconds,onlineSeconds,"
+           "offlineStepSeconds,onlineStepSeconds,speedup,breakEvenQueries,relativeError,peakRssKB\n";
+    for (const auto& r : results_) {
+        ofs << r.N << "," << r.k << "," << r.threads << "," << r.dt << "," << r.steps << ","
+            << r.offlineSeconds << "," << r.podSeconds << "," << r.assemblySeconds << ","
+            << r.onlineSeconds << "," << r.offlineStepSeconds << "," << r.onlineStepSeconds << ","
+            << r.speedup << "," << r.breakEvenQueries << "," << r.relativeError << ","
+            << r.peakRssKB << "\n";
+    }
+}
+
+void ScalingStudy::writeJSON(const std::string& file) const {
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs.precision(8);
+    ofs << "[";
+    for (std::size_t i = 0; i < results_.size(); i++) {
+        const auto& r = results_[i];
+        ofs << (i ? "," : "") << "\n  {\"N\": " << r.N << ", \"k\": " << r.k
+            << ", \"threads\": " << r.threads << ", \"dt\": " << r.dt
+            << ", \"steps\": " << r.steps
+            << ", \"offlineSeconds\": " << r.offlineSeconds
+            << ", \"podSeconds\": " << r.podSeconds
+            << ", \"assemblySeconds\": " << r.assemblySeconds
+            << ", \"onlineSeconds\": " << r.onlineSeconds
+            << ", \"offlineStepSeconds\": " << r.offlineStepSeconds
+            << ", \"onlineStepSeconds\": " << r.onlineStepSeconds
+            << ", \"speedup\": " << r.speedup
+            << ", \"breakEvenQueries\": " << r.breakEvenQueries
+            << ", \"relativeError\": " << r.relativeError
+            << ", \"peakRssKB\": " << r.peakRssKB << "}";
+    }
+    ofs << "\n]\n";
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Config.h"
+
+// Scaling study description, in the same "key values..." format as the
+// sweep spec ('#' starts a comment):
+//
+//     grid       64 128 256 512    # Nx = Ny values
+//     modes      5 10 20           # POD modes k
+//     threads    1 4               # worker threads (0 = numThreads())
+//     finalTime  0.1               # simulated time per case
+//     snapshots  50                # snapshots per offline run
+//     csv        scaling.csv
+//     json       scaling.json      # optional
+//
+// The time step of each grid is the base dt, reduced if needed to stay
+// inside the explicit stability limits (0.2 dx^2/nu and 0.5 dx/|u0|), so
+// large grids stay stable.
+struct ScalingSpec
+{
+    std::vector<int> grids;
+    std::vector<int> modes;
+    std::vector<int> threads = {0};
+    double finalTime = 0.1;
+    int snapshots = 50;
+
+    std::string csvFile = "scaling.csv";
+    std::string jsonFile;
+
+    static ScalingSpec fromTXT(const std::string& filename);
+};
+
+// One (grid, k, threads) case
+struct ScalingResult
+{
+    int N, k, threads;
+    double dt;
+    int steps;
+    double offlineSeconds;      // full-order solve (all steps, no I/O)
+    double podSeconds;
+    double assemblySeconds;     // reduced operators
+    double onlineSeconds;       // projection, all reduced steps, reconstruction
+    double offlineStepSeconds;  // per step
+    double onlineStepSeconds;   // per step
+    double speedup;             // offlineSeconds / onlineSeconds
+    double breakEvenQueries;    // online queries that repay offline + POD + assembly
+    double relativeError;       // final ROM state vs final full-order state
+    long peakRssKB;             // RSS high-water mark of the case (POD to online
+                                // solve; the process maximum where it cannot be reset)
+};
+
+// For every grid size, runs the (serial) full-order solve once, then for
+// every thread count and k computes the POD, assembles the reduced
+// operators and runs the online solve from the same initial state, timing
+// every phase.
+// Results go to CSV and, optionally, JSON.
+class ScalingStudy {
+public:
+    ScalingStudy(const Config& base, const ScalingSpec& spec);
+
+    void run();
+    const std::vector<ScalingResult>& results() const { return results_; }
+
+    void writeCSV(const std::string& file) const;
+    void writeJSON(const std::string& file) const;
+
+private:
+    Config base_;
+    ScalingSpec spec_;
+    std::vector<ScalingResult> results_;
+
+    Config caseConfig(int N) const;
+};
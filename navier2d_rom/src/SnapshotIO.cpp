@@ -0,0 +1,191 @@
+#include "SnapshotIO.h"
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "Instrumentation.h"
+
+static const char kSnapshotMagic[8] = {'N','2','D','S','N','A','P','1'};
+
+Eigen::MatrixXd loadSnapshotMatrix(const std::string& file) {
+    ScopedTimer timer("snapshotIO");
+    std::ifstream ifs(file, std::ios::binary);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Cannot open snapshot file: " + file);
+    }
+
+    char magic[8] = {};
+    ifs.read(magic, sizeof(magic));
+    if (ifs.gcount() == sizeof(magic) &&
+        std::memcmp(magic, kSnapshotMagic, sizeof(magic)) == 0) {
+        ifs.seekg(0);
+        Eigen::MatrixXd X = readBinarySnapshots(ifs);
+        Instrumentation::count(Counter::BytesRead, X.size()*sizeof(double));
+        return X;
+    }
+
+    // Text format
+    ifs.clear();
+    ifs.seekg(0);
+    int n, m;
+    if (!(ifs >> n >> m))
+        throw std::runtime_error("Error reading snapshot header: " + file);
+    Eigen::MatrixXd X(n, m);
+    for (int row = 0; row < n; ++row) {
+        for (int col = 0; col < m; ++col) {
+            if (!(ifs >> X(row, col)))
+                throw std::runtime_error("Truncated snapshot file: " + file);
+        }
+    }
+    Instrumentation::count(Counter::BytesRead, static_cast<std::int64_t>(ifs.tellg()));
+    return X;
+}
+
+void saveSnapshotMatrix(const std::string& file, const Eigen::MatrixXd& X) {
+    ScopedTimer timer("snapshotIO");
+    const std::string ext = ".bin";
+    bool binary = file.size() >= ext.size() &&
+                  file.compare(file.size() - ext.size(), ext.size(), ext) == 0;
+    if (binary) {
+        SnapshotWriter writer(file, X.rows(), X.cols());
+        writer.writeRows(X);
+        writer.close();
+        return;
+    }
+
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs.precision(17);
+    ofs << X.rows() << " " << X.cols() << "\n";
+    for (Eigen::Index row = 0; row < X.rows(); row++) {
+        for (Eigen::Index col = 0; col < X.cols(); col++)
+            ofs << X(row, col) << " ";
+        ofs << "\n";
+    }
+    if (!ofs)
+        throw std::runtime_error("Error writing " + file);
+    Instrumentation::count(Counter::BytesWritten, static_cast<std::int64_t>(ofs.tellp()));
+}
+
+std::size_t writeBinarySnapshots(std::ostream& os,
+                                 const std::vector<Eigen::VectorXd>& columns)
+{
+    std::int64_t m = columns.size();
+    std::int64_t n = columns.empty() ? 0 : columns[0].size();
+    os.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+    os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    os.write(reinterpret_cast<const char*>(&m), sizeof(m));
+
+    std::vector<double> row(m);
+    for (std::int64_t r = 0; r < n; r++) {
+        for (std::int64_t c = 0; c < m; c++)
+            row[c] = columns[c](r);
+        os.write(reinterpret_cast<const char*>(row.data()), m*sizeof(double));
+    }
+    if (!os)
+        throw std::runtime_error("Error writing binary snapshots");
+    return sizeof(kSnapshotMagic) + 2*sizeof(std::int64_t) + n*m*sizeof(double);
+}
+
+Eigen::MatrixXd readBinarySnapshots(std::istream& is) {
+    char magic[8];
+    std::int64_t n = 0, m = 0;
+    is.read(magic, sizeof(magic));
+    is.read(reinterpret_cast<char*>(&n), sizeof(n));
+    is.read(reinterpret_cast<char*>(&m), sizeof(m));
+    if (!is || std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a binary snapshot block");
+
+    // Rows are stored contiguously; read straight into a row-major map.
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> rm(n, m);
+    is.read(reinterpret_cast<char*>(rm.data()), n*m*sizeof(double));
+    if (!is)
+        throw std::runtime_error("Truncated binary snapshot block");
+    return rm;
+}
+
+SnapshotReader::SnapshotReader(const std::string& file)
+    : file_(file), ifs_(file, std::ios::binary)
+{
+    if (!ifs_.is_open()) {
+        throw std::runtime_error("Cannot open snapshot file: " + file);
+    }
+
+    char magic[8] = {};
+    ifs_.read(magic, sizeof(magic));
+    if (ifs_.gcount() == sizeof(magic) &&
+        std::memcmp(magic, kSnapshotMagic, sizeof(magic)) == 0) {
+        std::int64_t n, m;
+        ifs_.read(reinterpret_cast<char*>(&n), sizeof(n));
+        ifs_.read(reinterpret_cast<char*>(&m), sizeof(m));
+        binary_ = true;
+        n_ = n;
+        m_ = m;
+    } else {
+        ifs_.clear();
+        ifs_.seekg(0);
+        if (!(ifs_ >> n_ >> m_))
+            throw std::runtime_error("Error reading snapshot header: " + file);
+    }
+    if (!ifs_)
+        throw std::runtime_error("Error reading snapshot header: " + file);
+    dataStart_ = ifs_.tellg();
+}
+
+Eigen::Index SnapshotReader::readRows(Eigen::Index maxRows, Eigen::MatrixXd& block) {
+    Eigen::Index count = std::min(maxRows, n_ - nextRow_);
+    block.resize(count, m_);
+    if (count <= 0)
+        return 0;
+
+    std::streamoff start = ifs_.tellg();
+    if (binary_) {
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> rm(count, m_);
+        ifs_.read(reinterpret_cast<char*>(rm.data()), count*m_*sizeof(double));
+        block = rm;
+    } else {
+        for (Eigen::Index r = 0; r < count; r++)
+            for (Eigen::Index c = 0; c < m_; c++)
+                ifs_ >> block(r, c);
+    }
+    if (!ifs_)
+        throw std::runtime_error("Truncated snapshot file: " + file_);
+    Instrumentation::count(Counter::BytesRead, ifs_.tellg() - start);
+    nextRow_ += count;
+    return count;
+}
+
+void SnapshotReader::rewind() {
+    ifs_.clear();
+    ifs_.seekg(dataStart_);
+    nextRow_ = 0;
+}
+
+SnapshotWriter::SnapshotWriter(const std::string& file, Eigen::Index rows, Eigen::Index cols)
+    : file_(file), ofs_(file, std::ios::binary | std::ios::trunc), n_(rows), m_(cols)
+{
+    if (!ofs_.is_open()) {
+        throw std::runtime_error("Cannot open " + file);
+    }
+    std::int64_t n = rows, m = cols;
+    ofs_.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+    ofs_.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    ofs_.write(reinterpret_cast<const char*>(&m), sizeof(m));
+}
+
+void SnapshotWriter::writeRows(const Eigen::MatrixXd& block) {
+    if (block.cols() != m_ || written_ + block.rows() > n_)
+        throw std::runtime_error("Row block does not fit " + file_);
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> rm = block;
+    ofs_.write(reinterpret_cast<const char*>(rm.data()), rm.size()*sizeof(double));
+    Instrumentation::count(Counter::BytesWritten, rm.size()*sizeof(double));
+    written_ += block.rows();
+}
+
+void SnapshotWriter::close() {
+    ofs_.close();
+    if (!ofs_ || written_ != n_)
+        throw std::runtime_error("Error writing " + file_);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <Eigen/Dense>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Snapshot matrices are stored row-major (one row of the n x m matrix per
+// line / record), either as text:
+//     n m
+//     x(0,0) x(0,1) ... x(0,m-1)
+//     ...
+// or as binary: the 8-byte magic "N2DSNAP1", int64 n, int64 m, followed by
+// n*m doubles in the same row-major order.
+
+// Load a snapshot matrix from a text or binary file (detected by the magic).
+Eigen::MatrixXd loadSnapshotMatrix(const std::string& file);
+
+// Save X in binary format if file ends in ".bin", as text otherwise.
+void saveSnapshotMatrix(const std::string& file, const Eigen::MatrixXd& X);
+
+// Append one binary snapshot block built from the given columns to os.
+// Returns the number of bytes written.
+std::size_t writeBinarySnapshots(std::ostream& os,
+                                 const std::vector<Eigen::VectorXd>& columns);
+
+// Read one binary snapshot block from is (positioned at its magic).
+Eigen::MatrixXd readBinarySnapshots(std::istream& is);
+
+// Sequential row-block reader over a text or binary snapshot file, for
+// matrices that do not fit in memory.
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& file);
+
+    Eigen::Index rows() const { return n_; }
+    Eigen::Index cols() const { return m_; }
+
+    // Read up to maxRows further rows into block (resized to rows read x m).
+    // Returns the number of rows read; 0 at the end of the matrix.
+    Eigen::Index readRows(Eigen::Index maxRows, Eigen::MatrixXd& block);
+
+    // Go back to the first row
+    void rewind();
+
+private:
+    std::string file_;
+    std::ifstream ifs_;
+    bool binary_ = false;
+    Eigen::Index n_ = 0, m_ = 0;
+    Eigen::Index nextRow_ = 0;
+    std::streampos dataStart_;
+};
+
+// Binary snapshot file written a row block at a time.
+class SnapshotWriter {
+public:
+    SnapshotWriter(const std::string& file, Eigen::Index rows, Eigen::Index cols);
+
+    // Append block (k x cols) as the next k rows
+    void writeRows(const Eigen::MatrixXd& block);
+
+    // Flush and check that exactly rows() rows were written
+    void close();
+
+private:
+    std::string file_;
+    std::ofstream ofs_;
+    Eigen::Index n_, m_;
+    Eigen::Index written_ = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free single-producer/single-consumer queue. Exactly one
+// thread may push and exactly one (other) thread may pop; neither ever
+// blocks. Capacity is rounded up to a power of two.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t cap = 2;
+        while (cap < capacity)
+            cap <<= 1;
+        buffer_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    std::size_t capacity() const { return buffer_.size(); }
+
+    // Producer: false if the ring is full (the item is not stored)
+    bool tryPush(const T& item) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tailCache_ == buffer_.size()) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head - tailCache_ == buffer_.size())
+                return false;
+        }
+        buffer_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: false if the ring is empty
+    bool tryPop(T& item) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == headCache_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail == headCache_)
+                return false;
+        }
+        item = buffer_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> buffer_;
+    std::size_t mask_;
+
+    // Producer and consumer indices on separate cache lines, each with a
+    // cached copy of the other side's index to avoid cross-core traffic
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t tailCache_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t headCache_ = 0;
+};
@@ -0,0 +1,73 @@
+#include "TSQR.h"
+#include <Eigen/QR>
+#include <algorithm>
+#include <vector>
+#include "Parallel.h"
+
+// Upper-triangular factor of A (min(rows, m) x m)
+static Eigen::MatrixXd qrR(const Eigen::MatrixXd& A) {
+    Eigen::Index r = std::min(A.rows(), A.cols());
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(A);
+    return qr.matrixQR().topRows(r).triangularView<Eigen::Upper>();
+}
+
+// R of [A; B]
+static Eigen::MatrixXd mergeR(const Eigen::MatrixXd& A, const Eigen::MatrixXd& B) {
+    Eigen::MatrixXd stacked(A.rows() + B.rows(), A.cols());
+    stacked << A, B;
+    return qrR(stacked);
+}
+
+// Pairwise tree reduction; each level merges disjoint pairs in parallel.
+static Eigen::MatrixXd reduceTree(std::vector<Eigen::MatrixXd> Rs) {
+    while (Rs.size() > 1) {
+        std::size_t pairs = Rs.size() / 2;
+        std::vector<Eigen::MatrixXd> next((Rs.size() + 1) / 2);
+        parallelFor(0, static_cast<int>(pairs), [&](int p) {
+            next[p] = mergeR(Rs[2*p], Rs[2*p + 1]);
+        });
+        if (Rs.size() % 2)
+            next.back() = std::move(Rs.back());
+        Rs = std::move(next);
+    }
+    return Rs.empty() ? Eigen::MatrixXd() : Rs.front();
+}
+
+Eigen::MatrixXd tsqrR(SnapshotReader& reader, Eigen::Index blockRows,
+                      double* squaredNorm)
+{
+    const Eigen::Index m = reader.cols();
+    // Blocks shorter than m carry no reduction; keep them at least m tall.
+    blockRows = std::max(blockRows, m);
+    const int batch = numThreads();
+
+    reader.rewind();
+    Eigen::MatrixXd R;  // running factor of all rows read so far
+    double norm2 = 0.0;
+    std::vector<Eigen::MatrixXd> blocks(batch);
+
+    for (;;) {
+        // Reading is sequential; factorization of the batch is parallel.
+        int filled = 0;
+        while (filled < batch && reader.readRows(blockRows, blocks[filled]) > 0)
+            filled++;
+        if (filled == 0)
+            break;
+
+        for (int b = 0; b < filled; b++)
+            norm2 += blocks[b].squaredNorm();
+
+        std::vector<Eigen::MatrixXd> Rs(filled);
+        parallelFor(0, filled, [&](int b) { Rs[b] = qrR(blocks[b]); });
+        if (R.size() > 0)
+            Rs.push_back(std::move(R));
+        R = reduceTree(std::move(Rs));
+
+        if (filled < batch)
+            break;
+    }
+
+    if (squaredNorm)
+        *squaredNorm = norm2;
+    return R;
+}
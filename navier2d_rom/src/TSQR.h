@@ -0,0 +1,12 @@
+#pragma once
+#include <Eigen/Dense>
+#include "SnapshotIO.h"
+
+// Tall-skinny QR over a snapshot file that is streamed in row blocks.
+// Only the m x m R factor is formed: each batch of blocks (one per worker)
+// is factorized in parallel and the per-block R factors are merged pairwise
+// in a binary tree, so at most numThreads() blocks are resident at a time.
+//
+// If squaredNorm is given it receives ||X||_F^2, accumulated on the same pass.
+Eigen::MatrixXd tsqrR(SnapshotReader& reader, Eigen::Index blockRows,
+                      double* squaredNorm = nullptr);
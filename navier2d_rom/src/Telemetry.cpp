@@ -0,0 +1,66 @@
+#include "Telemetry.h"
+#include <chrono>
+#include <stdexcept>
+
+static_assert(sizeof(TelemetryRecord) == 64, "TelemetryRecord layout is part of the log format");
+
+static const char kTelemetryMagic[8] = {'N','2','D','T','L','M','0','1'};
+
+TelemetryWriter::TelemetryWriter(const std::string& file, std::size_t capacity)
+    : file_(file), ring_(capacity)
+{
+    const std::string ext = ".bin";
+    binary_ = file.size() >= ext.size() &&
+              file.compare(file.size() - ext.size(), ext.size(), ext) == 0;
+    ofs_.open(file, binary_ ? std::ios::binary | std::ios::trunc : std::ios::trunc);
+    if (!ofs_.is_open())
+        throw std::runtime_error("Cannot open telemetry file " + file);
+    if (binary_) {
+        ofs_.write(kTelemetryMagic, sizeof(kTelemetryMagic));
+    } else {
+        ofs_.precision(10);
+        ofs_ << "source,step,time,dt,maxVelocity,cfl,kineticEnergy,stepSeconds\n";
+    }
+    ofs_.flush();
+    thread_ = std::thread(&TelemetryWriter::drainLoop, this);
+}
+
+void TelemetryWriter::close() {
+    if (!thread_.joinable())
+        return;
+    stop_ = true;
+    thread_.join();
+    ofs_.close();
+}
+
+void TelemetryWriter::drainLoop() {
+    TelemetryRecord r;
+    for (;;) {
+        // Read stop_ before draining, so records pushed before the stop
+        // request are always written
+        bool stopping = stop_.load();
+        int batch = 0;
+        while (ring_.tryPop(r)) {
+            write(r);
+            batch++;
+        }
+        if (batch > 0) {
+            ofs_.flush();
+            written_ += batch;
+        }
+        if (stopping)
+            return;
+        if (batch == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+void TelemetryWriter::write(const TelemetryRecord& r) {
+    if (binary_) {
+        ofs_.write(reinterpret_cast<const char*>(&r), sizeof(r));
+        return;
+    }
+    ofs_ << (r.source == kOffline ? "offline" : "online") << "," << r.step << ","
+         << r.time << "," << r.dt << "," << r.maxVelocity << "," << r.cfl << ","
+         << r.kineticEnergy << "," << r.stepSeconds << "\n";
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "SpscRing.h"
+
+// One per-step telemetry record
+struct TelemetryRecord
+{
+    std::int32_t source;   // TelemetryWriter::kOffline or kOnline
+    std::int32_t pad;
+    std::int64_t step;
+    double time;
+    double dt;
+    double maxVelocity;    // max |(u, v)|; an upper bound for online records
+    double cfl;            // dt (max|u|/dx + max|v|/dy), same caveat
+    double kineticEnergy;  // 0.5 sum (u^2 + v^2) dx dy
+    double stepSeconds;    // wall time of the step
+};
+
+// Live telemetry log. The solver thread pushes records into a lock-free
+// SPSC ring; a background thread drains it and appends to the log,
+// flushing after every batch so the file can be followed while the run
+// is in progress. push() never blocks: if the writer falls behind and the
+// ring is full, the record is dropped and counted.
+//
+// Log format by extension: ".bin" is the magic "N2DTLM01" followed by raw
+// TelemetryRecord structs (64 bytes each, native endianness); anything
+// else is CSV with a header line.
+//
+// Only one thread may push at a time (solvers attached to the same writer
+// must run one after another).
+class TelemetryWriter {
+public:
+    static constexpr std::int32_t kOffline = 0;
+    static constexpr std::int32_t kOnline = 1;
+
+    explicit TelemetryWriter(const std::string& file, std::size_t capacity = 1 << 14);
+    ~TelemetryWriter() { close(); }
+
+    // Drain the remaining records, stop the writer thread and close the log
+    void close();
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    bool push(const TelemetryRecord& r) {
+        if (ring_.tryPush(r))
+            return true;
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::int64_t written() const { return written_.load(); }
+    std::int64_t dropped() const { return dropped_.load(); }
+
+private:
+    std::string file_;
+    bool binary_;
+    std::ofstream ofs_;
+    SpscRing<TelemetryRecord> ring_;
+    std::atomic<bool> stop_{false};
+    std::atomic<std::int64_t> written_{0};
+    std::atomic<std::int64_t> dropped_{0};
+    std::thread thread_;
+
+    void drainLoop();
+    void write(const TelemetryRecord& r);
+};
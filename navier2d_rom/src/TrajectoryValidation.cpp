@@ -0,0 +1,47 @@
+#include "TrajectoryValidation.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include "ParallelLinAlg.h"
+
+std::vector<TrajectoryErrorRecord> validateTrajectory(const Eigen::MatrixXd& Phi,
+                                                      const Eigen::MatrixXd& X,
+                                                      const Eigen::MatrixXd& A,
+                                                      const std::vector<double>& times)
+{
+    if (X.rows() != Phi.rows() || A.rows() != Phi.cols())
+        throw std::runtime_error("validateTrajectory: basis, snapshots and reduced states do not match");
+    if (X.cols() != A.cols() || static_cast<Eigen::Index>(times.size()) != X.cols())
+        throw std::runtime_error("validateTrajectory: " + std::to_string(X.cols()) + " snapshots but "
+                                 + std::to_string(A.cols()) + " reduced states");
+
+    // Phi^T X in one pass over X; everything below is O(k m)
+    Eigen::MatrixXd B = parallelTransposeMultiply(Phi, X);
+    Eigen::RowVectorXd xx = X.colwise().squaredNorm();
+
+    std::vector<TrajectoryErrorRecord> records(X.cols());
+    for (Eigen::Index j = 0; j < X.cols(); j++) {
+        double proj2 = std::max(0.0, xx(j) - B.col(j).squaredNorm());
+        double dyn2 = (B.col(j) - A.col(j)).squaredNorm();
+        records[j] = {times[j], std::sqrt(xx(j)), std::sqrt(proj2), std::sqrt(dyn2),
+                      std::sqrt(proj2 + dyn2)};
+    }
+    return records;
+}
+
+void writeTrajectoryErrors(const std::string& file,
+                           const std::vector<TrajectoryErrorRecord>& records)
+{
+    std::ofstream ofs(file);
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open " + file);
+    ofs.precision(10);
+    ofs << "time,reference,projection,dynamics,total,relProjection,relDynamics,relTotal\n";
+    for (const auto& r : records) {
+        double ref = r.reference + 1e-14;
+        ofs << r.time << "," << r.reference << "," << r.projection << "," << r.dynamics << ","
+            << r.total << "," << r.projection/ref << "," << r.dynamics/ref << ","
+            << r.total/ref << "\n";
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+// Errors of a ROM trajectory against the full-order snapshot x at one time
+struct TrajectoryErrorRecord
+{
+    double time;
+    double reference;   // ||x||
+    double projection;  // ||x - Phi Phi^T x||, best the basis can do
+    double dynamics;    // ||Phi^T x - a||, error of the reduced dynamics
+    double total;       // ||x - Phi a|| = sqrt(projection^2 + dynamics^2)
+};
+
+// Compares the ROM states A (k x m, column j = a(t_j)) with the snapshots
+// X (n x m) at every time without reconstructing any field. With an
+// orthonormal basis Phi (n x k),
+//
+//   ||x - Phi a||^2 = ||x||^2 - 2 a^T Phi^T x + ||a||^2
+//                   = (||x||^2 - ||Phi^T x||^2) + ||Phi^T x - a||^2,
+//
+// so one blocked GEMM Phi^T X (parallelTransposeMultiply) and the column
+// norms of X give every error: O(n k m) in total, less than reconstructing
+// the m states. The second form splits the error into its projection and
+// dynamics parts and avoids the cancellation of the first.
+std::vector<TrajectoryErrorRecord> validateTrajectory(const Eigen::MatrixXd& Phi,
+                                                      const Eigen::MatrixXd& X,
+                                                      const Eigen::MatrixXd& A,
+                                                      const std::vector<double>& times);
+
+// CSV: time, reference, projection, dynamics, total and the three relative
+// errors
+void writeTrajectoryErrors(const std::string& file,
+                           const std::vector<TrajectoryErrorRecord>& records);
@@ -0,0 +1,18 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+// Small helpers shared by the spec readers and the timed stages
+
+// Text before the first '#' of a spec file line
+inline std::string stripComment(std::string line) {
+    auto pos = line.find('#');
+    if (pos != std::string::npos)
+        line = line.substr(0, pos);
+    return line;
+}
+
+// Wall-clock seconds elapsed since t0
+inline double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
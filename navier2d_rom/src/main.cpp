@@ -1,95 +1,68 @@
 #include <iostream>
-#include <Eigen/Dense>
-#include <fstream>
-#include "Config.h"
-#include "OfflineSolver2D.h"
-#include "POD.h"
-#include "GalerkinROM.h"
-#include "OnlineSolver2D.h"
+#include <string>
+#include "Instrumentation.h"
+#include "Pipeline.h"
 
-// Helper function: load snapshot matrix from a text file.
-// The first line of the file must contain two integers: n (rows) and m (columns),
-// followed by n*m double values.
-Eigen::MatrixXd loadSnapshotMatrix(const std::string& file) {
-    std::ifstream ifs(file);
-    if (!ifs.is_open()) {
-        throw std::runtime_error("Cannot open snapshot file: " + file);
-    }
-    int n, m;
-    ifs >> n >> m;  // Read matrix dimensions.
-    Eigen::MatrixXd X(n, m);
-    for (int row = 0; row < n; ++row) {
-        for (int col = 0; col < m; ++col) {
-            double val;
-            ifs >> val;
-            X(row, col) = val;
-        }
-    }
-    return X;
+static void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [run|simulate|train|predict|evaluate|sweep|scale|greedy|parareal|serve|query] [--option value ...]\n"
+              << "  run      [--config C]\n"
+              << "  simulate [--config C] [--snapshots S]\n"
+              << "  train    [--config C] --snapshots S --basis B [--operators O]\n"
+              << "  predict  [--config C] --basis B [--operators O] [--initial X0] --output P\n"
+              << "  evaluate --prediction P --snapshots S [--column j] [--output M]\n"
+              << "  sweep    [--config C] --spec SW\n"
+              << "  scale    [--config C] --spec SC\n"
+              << "  greedy   [--config C] --spec G\n"
+              << "  parareal [--config C] [--basis B [--operators O]] --output P [--reference]\n"
+              << "  serve    [--config C] --basis B [--operators O] --socket P [--batch-window-us W]\n"
+              << "  query    --socket P [--config C] [--initial X0] [--final-time T] [--viscosity nu]\n"
+              << "           [--reduced] [--count N] [--output R] [--shutdown]\n"
+              << "Stages skip work when their inputs are unchanged; --force reruns.\n"
+              << "Any subcommand accepts --report R to write a JSON timing/counter report.\n";
 }
 
-int main() {
-    try {
-        // 1. Read configuration from config.txt.
-        // The config.txt file is expected to be in the parent directory of the build folder.
-        Config cfg = Config::fromTXT("../config.txt");
-
-        std::cout << "[main] Loaded configuration:\n";
-        std::cout << "  Grid: " << cfg.Nx << " x " << cfg.Ny << ", Domain: " 
-                  << cfg.Lx << " x " << cfg.Ly << "\n";
-        std::cout << "  Time: dt = " << cfg.dt << ", finalTime = " << cfg.finalTime << "\n";
-        std::cout << "  Viscosity: " << cfg.viscosity << "\n";
-        std::cout << "  Snapshot Interval: " << cfg.snapshotInterval << "\n";
-        std::cout << "  Snapshot File: " << cfg.snapshotFile << "\n";
-        std::cout << "  Number of POD Modes: " << cfg.numPodModes << "\n";
-
-        // 2. Run the full offline solver (simulate PDE and save snapshots).
-        std::cout << "[main] Running offline PDE solver...\n";
-        OfflineSolver2D offline(cfg);
-        offline.runOfflineSolve();
-        std::cout << "[main] Offline PDE solve completed.\n";
-
-        // 3. Load the snapshot matrix generated by the offline solver.
-        Eigen::MatrixXd X = loadSnapshotMatrix(cfg.snapshotFile);
-        std::cout << "[main] Loaded snapshot matrix with dimensions: " 
-                  << X.rows() << " x " << X.cols() << "\n";
-
-        // 4. Compute the POD basis from the snapshot matrix.
-        POD pod(cfg.numPodModes);
-        pod.computeBasis(X);
-        std::cout << "[main] POD basis computed.\n";
-
-        // 5. Build the Galerkin ROM using the POD basis.
-        double dx = cfg.Lx / (cfg.Nx - 1);
-        double dy = cfg.Ly / (cfg.Ny - 1);
-        GalerkinROM gal(pod, cfg.Nx, cfg.Ny, dx, dy, cfg.viscosity);
-        std::cout << "[main] Galerkin ROM constructed.\n";
+static int dispatch(const std::string& cmd, const StageArgs& args, const char* prog) {
+    if (cmd == "run")      return runAll(args);
+    if (cmd == "simulate") return runSimulate(args);
+    if (cmd == "train")    return runTrain(args);
+    if (cmd == "predict")  return runPredict(args);
+    if (cmd == "evaluate") return runEvaluate(args);
+    if (cmd == "sweep")    return runSweep(args);
+    if (cmd == "scale")    return runScale(args);
+    if (cmd == "greedy")   return runGreedy(args);
+    if (cmd == "parareal") return runParareal(args);
+    if (cmd == "serve")    return runServe(args);
+    if (cmd == "query")    return runQuery(args);
 
-        // 6. Select an initial condition for the online (reduced) simulation.
-        // Here, we take the first column from the snapshot matrix.
-        Eigen::VectorXd x0 = X.col(0);
-        std::cout << "[main] Initial condition loaded from snapshot.\n";
-
-        // 7. Run the online reduced-order simulation.
-        OnlineSolver2D online(cfg, gal);
-        Eigen::VectorXd xFinalROM = online.runReducedSolve(x0);
-        std::cout << "[main] Online reduced simulation completed.\n";
-
-        // 8. For comparison, get the final offline snapshot (last column).
-        Eigen::VectorXd xFinalOffline = X.col(X.cols() - 1);
-
-        // 9. Compute the error between the offline and ROM solutions.
-        double errorNorm = (xFinalOffline - xFinalROM).norm();
-        double refNorm = xFinalOffline.norm();
-        double relativeError = errorNorm / (refNorm + 1e-14);
+    printUsage(prog);
+    return 1;
+}
 
-        std::cout << "[main] Offline final solution norm: " << refNorm << "\n";
-        std::cout << "[main] ROM final solution norm: " << xFinalROM.norm() << "\n";
-        std::cout << "[main] Relative error: " << relativeError << "\n";
+int main(int argc, char** argv) {
+    std::string report;
+    int rc = 1;
+    try {
+        // Without a subcommand, run the whole pipeline in memory as before.
+        bool hasCmd = argc > 1 && std::string(argv[1]).rfind("--", 0) != 0;
+        std::string cmd = hasCmd ? argv[1] : "run";
+        StageArgs args = StageArgs::parse(argc, argv, hasCmd ? 2 : 1);
+        report = args.get("report");
+        if (!report.empty())
+            Instrumentation::enable();
 
-        return 0;
+        rc = dispatch(cmd, args, argv[0]);
     } catch (const std::exception &ex) {
         std::cerr << "[main] Exception: " << ex.what() << "\n";
-        return 1;
     }
+
+    // The report covers failed runs too
+    if (!report.empty()) {
+        try {
+            Instrumentation::writeReport(report);
+            std::cout << "[main] Wrote instrumentation report to " << report << "\n";
+        } catch (const std::exception &ex) {
+            std::cerr << "[main] Exception: " << ex.what() << "\n";
+        }
+    }
+    return rc;
 }
@@ -0,0 +1,102 @@
+// Regression check of the Field2D row kernels against the indexed
+// five-point stencil the offline solver used before Field2D (node (i, j)
+// at i + j*Nx, neighbours looked up by index). Returns non-zero on
+// mismatch.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "Field2D.h"
+
+static const int Nx = 13, Ny = 9;
+static const double nu = 0.01;
+
+// Smooth field plus a deterministic perturbation, so every term of the
+// stencil contributes
+static std::vector<double> testField(double phase) {
+    std::vector<double> f(Nx*Ny);
+    unsigned s = 12345u + static_cast<unsigned>(phase*1000);
+    for (int j = 0; j < Ny; j++) {
+        for (int i = 0; i < Nx; i++) {
+            s = s*1664525u + 1013904223u;
+            f[i + j*Nx] = std::sin(0.7*i + phase)*std::cos(0.4*j - phase)
+                        + 0.1*(s >> 8)/double(1u << 24);
+        }
+    }
+    return f;
+}
+
+// Old stencil: residual at (i, j), neighbours through idx
+static void indexedResidual(const std::vector<double>& u, const std::vector<double>& v,
+                            const std::function<int(int, int)>& idx, int i, int j,
+                            double dx, double dy, double& Ru, double& Rv) {
+    auto lap = [&](const std::vector<double>& phi) {
+        double d2x = (phi[idx(i-1,j)] - 2*phi[idx(i,j)] + phi[idx(i+1,j)])/(dx*dx);
+        double d2y = (phi[idx(i,j-1)] - 2*phi[idx(i,j)] + phi[idx(i,j+1)])/(dy*dy);
+        return d2x + d2y;
+    };
+    double dudx = (u[idx(i+1,j)] - u[idx(i-1,j)])/(2*dx);
+    double dudy = (u[idx(i,j+1)] - u[idx(i,j-1)])/(2*dy);
+    double dvdx = (v[idx(i+1,j)] - v[idx(i-1,j)])/(2*dx);
+    double dvdy = (v[idx(i,j+1)] - v[idx(i,j-1)])/(2*dy);
+    int id = idx(i,j);
+    double convU = u[id]*dudx + v[id]*dudy;
+    double convV = u[id]*dvdx + v[id]*dvdy;
+    Ru = -convU + nu*lap(u);
+    Rv = -convV + nu*lap(v);
+}
+
+static int check(BoundaryCondition bc, const char* name) {
+    const bool periodic = bc == BoundaryCondition::Periodic;
+    const double dx = 1.0 / (periodic ? Nx : Nx - 1);
+    const double dy = 1.0 / (periodic ? Ny : Ny - 1);
+    std::vector<double> u = testField(0.3), v = testField(1.1);
+    if (!periodic) {
+        // Dirichlet state as the solver holds it: zero boundary nodes
+        for (int j = 0; j < Ny; j++)
+            for (int i = 0; i < Nx; i++)
+                if (i == 0 || j == 0 || i == Nx-1 || j == Ny-1)
+                    u[i + j*Nx] = v[i + j*Nx] = 0.0;
+    }
+
+    Field2D fu(Nx, Ny), fv(Nx, Ny);
+    fu.load(u.data());
+    fv.load(v.data());
+    fu.fillGhosts(bc);
+    fv.fillGhosts(bc);
+
+    auto idx = [&](int i, int j) {
+        if (periodic) {
+            i = (i + Nx) % Nx;
+            j = (j + Ny) % Ny;
+        }
+        return i + j*Nx;
+    };
+
+    // Dirichlet: the old solver only updated interior nodes; the boundary
+    // is overwritten by applyBoundary, so only the interior is compared
+    const int lo = periodic ? 0 : 1;
+    double maxDiff = 0.0;
+    std::vector<double> Ru(Nx), Rv(Nx);
+    for (int j = lo; j < Ny - lo; j++) {
+        residualRow(fu, fv, j, nu, dx, dy, Ru.data(), Rv.data());
+        for (int i = lo; i < Nx - lo; i++) {
+            double ru, rv;
+            indexedResidual(u, v, idx, i, j, dx, dy, ru, rv);
+            maxDiff = std::max({maxDiff, std::abs(Ru[i] - ru), std::abs(Rv[i] - rv)});
+        }
+    }
+
+    // Same arithmetic in the same order; the tolerance only allows for
+    // contracted multiply-adds
+    std::printf("%s: max |residualRow - indexed stencil| = %g\n", name, maxDiff);
+    return maxDiff <= 1e-12 ? 0 : 1;
+}
+
+int main() {
+    int failures = 0;
+    failures += check(BoundaryCondition::Dirichlet, "dirichlet");
+    failures += check(BoundaryCondition::Periodic, "periodic");
+    return failures;
+}
@@ -0,0 +1,135 @@
+// Check of the public RomCore API against the model it loads: a small
+// Burgers run is trained with each stepped romType and saved as the train
+// stage would, then reduce -> advance -> reconstruct and probe() through
+// RomCore must reproduce the model's own predict, and size mismatches
+// must throw. Returns non-zero on failure.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "navier2d_rom/RomCore.h"
+#include "Config.h"
+#include "ModelRegistry.h"
+#include "OfflineSolver2D.h"
+
+static const int Nx = 16, Ny = 12;
+
+static void writeConfig(const std::string& file, const std::string& romType) {
+    std::ofstream ofs(file);
+    ofs << Nx << "\n" << Ny << "\n1.0\n1.0\n"
+        << "0.001\n0.05\n0.01\n5\nromcore_test_snapshots.txt\n6\n"
+        << "romType " << romType << "\n";
+}
+
+static double relDiff(const Eigen::VectorXd& x, const Eigen::VectorXd& ref) {
+    return (x - ref).norm() / std::max(ref.norm(), 1e-300);
+}
+
+template <typename F>
+static bool throws(F f) {
+    try {
+        f();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+static int check(const std::string& romType) {
+    const std::string cfgFile = "romcore_test_" + romType + ".txt";
+    const std::string basisFile = "romcore_test_" + romType + ".bin";
+    writeConfig(cfgFile, romType);
+    Config cfg = Config::fromTXT(cfgFile);
+
+    OfflineSolver2D fom(cfg);
+    fom.simulate();
+    const auto& snaps = fom.snapshots();
+    Eigen::MatrixXd X(snaps.front().size(), snaps.size());
+    for (std::size_t j = 0; j < snaps.size(); j++)
+        X.col(j) = snaps[j];
+
+    auto model = ModelRegistry::create(romType, cfg);
+    model->train(X);
+    model->save(basisFile, basisFile + ".ops");
+
+    RomCore rom(cfgFile, basisFile);
+    const int k = rom.numModes();
+    const Eigen::Index n = rom.stateSize();
+    int failures = 0;
+
+    // Single states stepped in place against the batched predict of the
+    // same loaded model, and against the trained model's predict
+    const int B = 3;
+    Eigen::MatrixXd X0 = X.leftCols(B), P(n, B);
+    rom.predict(X0, P);
+    Eigen::VectorXd a(k), x(n);
+    double maxDiff = 0.0;
+    for (int b = 0; b < B; b++) {
+        rom.reduce(X0.col(b), a);
+        rom.advance(a, cfg.finalTime);
+        rom.reconstruct(a, x);
+        maxDiff = std::max({maxDiff, relDiff(x, P.col(b)), relDiff(x, model->predict(X0.col(b)))});
+    }
+    std::printf("%s: max relative |step - predict| = %g\n", romType.c_str(), maxDiff);
+    failures += maxDiff <= 1e-10 ? 0 : 1;
+
+    // step() by hand over the same number of steps gives the same state
+    Eigen::VectorXd b(k);
+    rom.reduce(X0.col(B-1), b);
+    const int steps = static_cast<int>(std::ceil(cfg.finalTime/cfg.dt));
+    for (int s = 0; s < steps; s++)
+        rom.step(b);
+    failures += relDiff(b, a) <= 1e-12 ? 0 : 1;
+
+    // Probes at a node and at a cell centre, against the predicted field
+    const double dx = cfg.dx(), dy = cfg.dy();
+    rom.setProbes({{{3*dx, 5*dy}}, {{7.5*dx, 2.5*dy}}});
+    Eigen::VectorXd values(2*rom.numProbes());
+    rom.probe(a, values);
+    const Eigen::VectorXd& xp = P.col(B-1);
+    auto node = [&](int i, int j, int comp) { return xp(i + j*Nx + comp*Nx*Ny); };
+    double probeDiff = 0.0;
+    for (int comp = 0; comp < 2; comp++) {
+        double atNode = node(3, 5, comp);
+        double atCentre = 0.25*(node(7, 2, comp) + node(8, 2, comp)
+                                + node(7, 3, comp) + node(8, 3, comp));
+        probeDiff = std::max({probeDiff, std::abs(values(2*comp) - atNode),
+                              std::abs(values(2*comp + 1) - atCentre)});
+    }
+    std::printf("%s: max |probe - interpolated predict| = %g\n", romType.c_str(), probeDiff);
+    failures += probeDiff <= 1e-10 ? 0 : 1;
+
+    // Every query checks its sizes
+    Eigen::VectorXd shortA(k - 1), shortX(n - 1), shortValues(1);
+    Eigen::MatrixXd shortX0(n - 1, 1), shortP(n - 1, 1);
+    const bool allThrow =
+        throws([&] { rom.reduce(shortX, a); }) &&
+        throws([&] { rom.reduce(x, shortA); }) &&
+        throws([&] { rom.step(shortA); }) &&
+        throws([&] { rom.advance(shortA, 0.01); }) &&
+        throws([&] { rom.reconstruct(shortA, x); }) &&
+        throws([&] { rom.reconstruct(a, shortX); }) &&
+        throws([&] { rom.predict(shortX0, shortP); }) &&
+        throws([&] { rom.probe(a, shortValues); }) &&
+        throws([&] { rom.probe(shortA, values); });
+    std::printf("%s: size mismatches %s\n", romType.c_str(), allThrow ? "throw" : "DO NOT all throw");
+    failures += allThrow ? 0 : 1;
+    return failures;
+}
+
+int main() {
+    int failures = 0;
+    for (const char* romType : {"galerkin", "opinf"}) {
+        try {
+            failures += check(romType);
+        } catch (const std::exception& ex) {
+            std::printf("%s: %s\n", romType, ex.what());
+            failures++;
+        }
+    }
+    return failures;
+}
@@ -0,0 +1,77 @@
+# Smoke test of the Python bindings (run by ctest when the module is
+# built): solve_batch from two threads at once, writing into caller-owned
+# buffers in place. Exits 77 (skipped) without NumPy.
+import sys
+import threading
+
+try:
+    import numpy as np
+except ImportError:
+    print("numpy not available")
+    sys.exit(77)
+
+import navier2d_rom as nr
+
+Nx, Ny, B = 16, 12, 6
+cfg = nr.Config()
+cfg.Nx, cfg.Ny, cfg.Lx, cfg.Ly = Nx, Ny, 1.0, 1.0
+dt, steps, nu = 1e-4, 20, 0.01
+
+# Smooth snapshots, so the Galerkin model is well behaved over a few steps
+x = np.linspace(0.0, 1.0, Nx)
+y = np.linspace(0.0, 1.0, Ny)
+X, Y = np.meshgrid(x, y)  # Ny x Nx, flattened row by row = i + j*Nx
+cols = []
+for p in range(12):
+    u = np.sin(np.pi*(p % 3 + 1)*X) * np.sin(np.pi*(p // 3 + 1)*Y)
+    v = np.cos(np.pi*(p % 4 + 1)*X) * np.sin(np.pi*(p % 2 + 1)*Y)
+    cols.append(np.concatenate([u.ravel(), v.ravel()]))
+snaps = np.asfortranarray(np.array(cols).T)
+
+pod = nr.POD(6)
+pod.compute_basis(snaps)
+rom = nr.GalerkinROM(pod, Nx, Ny, cfg.dx(), cfg.dy(), nu)
+rom.assemble_reduced_operators()
+
+X0 = np.asfortranarray(snaps[:, :B])
+expected = np.empty_like(X0, order="F")
+nr.solve_batch(rom, X0, expected, dt, steps)
+assert np.all(np.isfinite(expected))
+
+# Each thread writes its half of one shared F-ordered buffer through a
+# column-block view; with noconvert outputs, that only works in place.
+out = np.full((X0.shape[0], B), np.nan, order="F")
+halves = [slice(0, B // 2), slice(B // 2, B)]
+barrier = threading.Barrier(len(halves))
+errors = []
+
+def worker(cols):
+    try:
+        view = out[:, cols]
+        assert view.base is out or np.shares_memory(view, out)
+        barrier.wait()
+        for _ in range(10):
+            nr.solve_batch(rom, X0[:, cols], view, dt, steps)
+    except Exception as ex:  # reported from the main thread
+        errors.append(ex)
+
+threads = [threading.Thread(target=worker, args=(h,)) for h in halves]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+
+if errors:
+    raise errors[0]
+assert not np.isnan(out).any(), "output buffer was not written in place"
+assert np.allclose(out, expected, rtol=1e-12, atol=1e-12), "threaded result differs"
+
+# A C-ordered output cannot be written in place and must be rejected
+try:
+    nr.solve_batch(rom, X0, np.empty(X0.shape), dt, steps)
+except TypeError:
+    pass
+else:
+    raise AssertionError("C-ordered out was accepted")
+
+print("python bindings: solve_batch ok from", len(threads), "threads")